@@ -1402,7 +1402,7 @@ static bool player_birth_aux_3(void)
 			}
 
 			/* Prepare a prompt */
-			sprintf(buf, "%-5s%-20s", stat_names[i], inp);
+			strnfmt(buf, sizeof(buf), "%-5s%-20s", stat_names[i], inp);
 
 			/* Dump the prompt */
 			put_str(buf, 16 + i, 5);
@@ -1559,7 +1559,7 @@ static bool player_birth_aux_3(void)
 					}
 
 					/* Dump round */
-					put_str(format("%10ld", auto_round), 10, col+20);
+					put_str(format("%10ld", (long)auto_round), 10, col+20);
 
 					/* Make sure they see everything */
 					Term_fresh();
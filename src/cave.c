@@ -440,6 +440,76 @@ bool feat_supports_lighting(byte feat)
 }
 
 
+/*
+ * The remembered appearance of a grid (see "map_info()")
+ */
+typedef struct map_memo_type map_memo_type;
+
+struct map_memo_type
+{
+	u32b epoch;		/* Valid while this matches "map_epoch" */
+
+	byte a;			/* Attr */
+	char c;			/* Char */
+
+	byte ta;		/* Terrain attr */
+	char tc;		/* Terrain char */
+};
+
+/*
+ * The remembered appearance of every grid
+ */
+static map_memo_type map_memo[DUNGEON_HGT][DUNGEON_WID];
+
+/*
+ * The current epoch (never zero, so a zeroed entry is never valid)
+ */
+static u32b map_epoch = 1L;
+
+/*
+ * The lighting options in force during the current epoch
+ */
+static bool map_memo_special = FALSE;
+static bool map_memo_granite = FALSE;
+
+
+/*
+ * Forget the remembered appearance of every grid
+ *
+ * This must be done whenever anything changes the appearance of many grids
+ * at once, or of grids in general (options, visuals, blindness, a new
+ * level), which is always followed by a full redraw ("PR_MAP").
+ */
+void map_memo_forget(void)
+{
+	/* Start a new epoch */
+	if (!++map_epoch) map_epoch = 1L;
+
+	/* Note the change */
+	map_changes++;
+
+	/* Remember the lighting options */
+	map_memo_special = view_special_lite;
+	map_memo_granite = view_granite_lite;
+}
+
+
+/*
+ * Forget the remembered appearance of one grid
+ *
+ * Anything which changes the appearance of a grid must redraw it, so this
+ * is done by "lite_spot()" and "dirty_spot()", even for grids which are
+ * not on the current panel.
+ */
+static void map_memo_forget_spot(int y, int x)
+{
+	map_memo[y][x].epoch = 0L;
+
+	/* Note the change */
+	map_changes++;
+}
+
+
 /*
  * Extract the attr/char to display at the given (legal) map location
  *
@@ -608,6 +678,11 @@ bool feat_supports_lighting(byte feat)
  * ToDo: The transformations for tile colors, or brightness for the 16x16
  * tiles should be handled differently.  One possibility would be to
  * extend feature_type with attr/char definitions for the different states.
+ *
+ * The result is remembered in "map_memo[]" until the grid (or the whole
+ * map) is redrawn, so scrolling the panel and redrawing the map mostly
+ * reuse it.  Nothing is remembered while hallucinating, or for grids with
+ * multi-hued monsters, whose appearance changes on every call.
  */
 #ifdef USE_TRANSPARENCY
 void map_info(int y, int x, byte *ap, char *cp, byte *tap, char *tcp)
@@ -631,8 +706,34 @@ void map_info(int y, int x, byte *ap, char *cp)
 
 	int floor_num = 0;
 
+	bool graf_new;
+
+	map_memo_type *mm_ptr = &map_memo[y][x];
+
+	/* Not while hallucinating, or with lighting disabled ("display_map()") */
+	bool memo = (!image && (view_special_lite == map_memo_special) &&
+	             (view_granite_lite == map_memo_granite));
+
+
+	/* Use the remembered appearance */
+	if (memo && (mm_ptr->epoch == map_epoch))
+	{
+
+#ifdef USE_TRANSPARENCY
+
+		(*tap) = mm_ptr->ta;
+		(*tcp) = mm_ptr->tc;
+
+#endif /* USE_TRANSPARENCY */
+
+		(*ap) = mm_ptr->a;
+		(*cp) = mm_ptr->c;
+
+		return;
+	}
+
 	/* Hack -- Assume that "new" means "Adam Bolt Tiles" */
-	bool graf_new = (use_graphics && streq(ANGBAND_GRAF, "new"));
+	graf_new = (use_graphics && streq(ANGBAND_GRAF, "new"));
 
 	/* Monster/Player */
 	m_idx = cave_m_idx[y][x];
@@ -851,6 +952,10 @@ void map_info(int y, int x, byte *ap, char *cp)
 	(*tap) = a;
 	(*tcp) = c;
 
+	/* Remember it */
+	mm_ptr->ta = a;
+	mm_ptr->tc = c;
+
 #endif /* USE_TRANSPARENCY */
 
 	/* Objects */
@@ -963,6 +1068,9 @@ void map_info(int y, int x, byte *ap, char *cp)
 
 				/* Normal char */
 				c = dc;
+
+				/* Do not remember it */
+				memo = FALSE;
 			}
 
 			/* Normal monster (not "clear" in any way) */
@@ -1030,6 +1138,14 @@ void map_info(int y, int x, byte *ap, char *cp)
 		c = r_ptr->x_char;
 	}
 
+	/* Remember the result */
+	if (memo)
+	{
+		mm_ptr->epoch = map_epoch;
+		mm_ptr->a = a;
+		mm_ptr->c = c;
+	}
+
 	/* Result */
 	(*ap) = a;
 	(*cp) = c;
@@ -1218,6 +1334,9 @@ void lite_spot(int y, int x)
 	unsigned ky, kx;
 	unsigned vy, vx;
 
+	/* The grid has changed */
+	map_memo_forget_spot(y, x);
+
 	/* Location relative to panel */
 	ky = (unsigned)(y - p_ptr->wy);
 
@@ -1258,6 +1377,110 @@ void lite_spot(int y, int x)
 
 
 
+/*
+ * Map grids waiting to be redrawn (see "dirty_spot()")
+ *
+ * The bitset stops a grid from being listed twice, so a grid which changes
+ * several times between two redraws is only drawn once.  Only grids on the
+ * current panel are ever listed.
+ */
+static byte dirty_bits[DUNGEON_HGT][(DUNGEON_WID + 7) / 8];
+static u16b dirty_g[SCREEN_HGT * SCREEN_WID];
+static int dirty_n = 0;
+
+
+/*
+ * Forget the map grids waiting to be redrawn
+ */
+static void dirty_wipe(void)
+{
+	int i;
+
+	/* Clear the bits */
+	for (i = 0; i < dirty_n; i++)
+	{
+		int y = GRID_Y(dirty_g[i]);
+		int x = GRID_X(dirty_g[i]);
+
+		dirty_bits[y][x >> 3] &= ~(1 << (x & 7));
+	}
+
+	/* None left */
+	dirty_n = 0;
+
+	/* Nothing to draw */
+	p_ptr->redraw &= ~(PR_SPOTS);
+}
+
+
+/*
+ * Count the grids drawn in a frame of the map
+ */
+static void count_map_frame(int n)
+{
+	map_frames++;
+	map_grids += n;
+	map_grids_last = n;
+}
+
+
+/*
+ * Note that a map grid needs to be redrawn, at the next "redraw_stuff()"
+ * (or the next time the game waits for a key)
+ *
+ * This is used instead of "lite_spot()" where many grids may change at
+ * once, or the same grid may change many times before anything is shown,
+ * such as when the view changes or monsters move.
+ */
+void dirty_spot(int y, int x)
+{
+	/* The grid has changed */
+	map_memo_forget_spot(y, x);
+
+	/* Only grids on the panel are ever drawn */
+	if ((unsigned)(y - p_ptr->wy) >= (unsigned)(SCREEN_HGT)) return;
+	if ((unsigned)(x - p_ptr->wx) >= (unsigned)(SCREEN_WID)) return;
+
+	/* Already waiting */
+	if (dirty_bits[y][x >> 3] & (1 << (x & 7))) return;
+
+	/* Paranoia -- the panel has moved, so redraw everything */
+	if (dirty_n >= SCREEN_HGT * SCREEN_WID)
+	{
+		p_ptr->redraw |= (PR_PANEL);
+		return;
+	}
+
+	/* Remember the grid */
+	dirty_bits[y][x >> 3] |= (1 << (x & 7));
+	dirty_g[dirty_n++] = GRID(y, x);
+
+	/* Redraw it later */
+	p_ptr->redraw |= (PR_SPOTS);
+}
+
+
+/*
+ * Redraw (on the screen) the map grids waiting to be redrawn
+ */
+void prt_dirty_spots(void)
+{
+	int i, n = dirty_n;
+
+	/* Draw the grids */
+	for (i = 0; i < n; i++)
+	{
+		lite_spot(GRID_Y(dirty_g[i]), GRID_X(dirty_g[i]));
+	}
+
+	/* Forget them */
+	dirty_wipe();
+
+	/* Count them */
+	count_map_frame(n);
+}
+
+
 /*
  * Redraw (on the screen) the current map panel
  *
@@ -1309,6 +1532,12 @@ void prt_map(void)
 
 		}
 	}
+
+	/* Every grid has been drawn */
+	dirty_wipe();
+
+	/* Count them */
+	count_map_frame(SCREEN_HGT * SCREEN_WID);
 }
 
 
@@ -2514,7 +2743,7 @@ void forget_view(void)
 		/* fast_cave_info[g] &= ~(CAVE_LITE); */
 
 		/* Redraw */
-		lite_spot(y, x);
+		dirty_spot(y, x);
 	}
 
 	/* None left */
@@ -2915,7 +3144,7 @@ void update_view(void)
 			note_spot(y, x);
 
 			/* Redraw */
-			lite_spot(y, x);
+			dirty_spot(y, x);
 		}
 	}
 
@@ -2944,7 +3173,7 @@ void update_view(void)
 			x = GRID_X(g);
 
 			/* Redraw */
-			lite_spot(y, x);
+			dirty_spot(y, x);
 		}
 	}
 
@@ -3517,7 +3746,7 @@ void cave_set_feat(int y, int x, int feat)
 		note_spot(y, x);
 
 		/* Redraw */
-		lite_spot(y, x);
+		dirty_spot(y, x);
 	}
 }
 
@@ -1333,7 +1333,7 @@ static void natural_attack(s16b m_idx, int attack, bool *fear)
  */
 void py_attack(int y, int x)
 {
-	int num = 0, k, bonus, chance;
+	int num = 0, k, bonus, chance, old_stream;
 
 	monster_type *m_ptr;
 	monster_race *r_ptr;
@@ -1382,6 +1382,10 @@ void py_attack(int y, int x)
 	}
 
 
+	/* Roll the dice on the combat stream */
+	old_stream = Rand_stream_set(RAND_STREAM_COMBAT);
+
+
 	/* Get the weapon */
 	o_ptr = &inventory[INVEN_WIELD];
 
@@ -1499,6 +1503,9 @@ void py_attack(int y, int x)
 
 	/* Mega-Hack -- apply earthquake brand */
 	if (do_quake) earthquake(p_ptr->py, p_ptr->px, 10);
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
 
 
@@ -2390,7 +2390,7 @@ static int breakage_chance(const object_type *o_ptr)
  */
 void do_cmd_fire(void)
 {
-	int dir, item;
+	int dir, item, old_stream;
 	int i, j, y, x, ty, tx;
 	int tdam, tdis, thits, tmul;
 	int bonus, chance;
@@ -2449,6 +2449,9 @@ void do_cmd_fire(void)
 	/* Get a direction (or cancel) */
 	if (!get_aim_dir(&dir)) return;
 
+	/* Roll the dice on the combat stream */
+	old_stream = Rand_stream_set(RAND_STREAM_COMBAT);
+
 
 	/* Get local object */
 	i_ptr = &object_type_body;
@@ -2733,6 +2736,9 @@ void do_cmd_fire(void)
 
 	/* Drop (or break) near that location */
 	drop_near(i_ptr, j, y, x);
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
 
 
@@ -2748,7 +2754,7 @@ void do_cmd_fire(void)
  */
 void do_cmd_throw(void)
 {
-	int dir, item;
+	int dir, item, old_stream;
 	int i, j, y, x, ty, tx;
 	int chance, tdam, tdis;
 	int mul, div;
@@ -2792,6 +2798,9 @@ void do_cmd_throw(void)
 	/* Get a direction (or cancel) */
 	if (!get_aim_dir(&dir)) return;
 
+	/* Roll the dice on the combat stream */
+	old_stream = Rand_stream_set(RAND_STREAM_COMBAT);
+
 
 	/* Get local object */
 	i_ptr = &object_type_body;
@@ -3011,4 +3020,7 @@ void do_cmd_throw(void)
 
 	/* Drop (or break) near that location */
 	drop_near(i_ptr, j, y, x);
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
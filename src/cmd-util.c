@@ -420,6 +420,9 @@ void do_cmd_pref(void)
 
 	/* Process that pref command */
 	(void)process_pref_file_command(tmp);
+
+	/* The visuals may have changed */
+	map_memo_forget();
 }
 
 
@@ -2090,6 +2093,9 @@ void do_cmd_visuals(void)
 
 	/* Load screen */
 	screen_load();
+
+	/* The visuals may have changed */
+	map_memo_forget();
 }
 
 
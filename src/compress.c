@@ -0,0 +1,203 @@
+/* File: compress.c */
+#include "compress.h"
+#include <string.h>
+
+/* Shortest match worth encoding */
+#define MIN_MATCH 4
+
+/* Matches must start within this distance (the offset is 16 bits) */
+#define MAX_OFFSET 65535
+
+/* Size of the match finder hash table */
+#define HASH_BITS 12
+#define HASH_SIZE (1 << HASH_BITS)
+
+/* Nibble value meaning "more length bytes follow" */
+#define RUN_MASK 15
+
+/* Hash the four bytes at p */
+static unsigned int hash4(const unsigned char *p) {
+    unsigned long v = (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+                      ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+
+    return (unsigned int)(((v * 2654435761UL) & 0xFFFFFFFFUL) >> (32 - HASH_BITS));
+}
+
+/* Write the extra bytes of a length that did not fit in its nibble */
+static size_t put_length(unsigned char *dst, size_t op, size_t len) {
+    for (len -= RUN_MASK; len >= 255; len -= 255) {
+        dst[op++] = 255;
+    }
+    dst[op++] = (unsigned char)len;
+    return op;
+}
+
+size_t compress_bound(size_t len) {
+    return len + len / 255 + 16;
+}
+
+/*
+ * Write one sequence: the literals src[lit..lit+lit_len) then, if
+ * match_len is non-zero, a match of match_len bytes at the given offset
+ */
+static size_t put_sequence(const unsigned char *src, size_t lit, size_t lit_len,
+                           size_t offset, size_t match_len,
+                           unsigned char *dst, size_t op, size_t dst_size) {
+    size_t token = op;
+
+    /* Worst case: token, two length runs, literals and offset */
+    if (dst_size - op < 1 + lit_len + lit_len / 255 + 1 + 2 + match_len / 255 + 1) {
+        return 0;
+    }
+
+    op++;
+
+    if (lit_len >= RUN_MASK) {
+        dst[token] = RUN_MASK << 4;
+        op = put_length(dst, op, lit_len);
+    } else {
+        dst[token] = (unsigned char)(lit_len << 4);
+    }
+
+    memcpy(dst + op, src + lit, lit_len);
+    op += lit_len;
+
+    if (!match_len) {
+        return op;
+    }
+
+    dst[op++] = (unsigned char)(offset & 0xFF);
+    dst[op++] = (unsigned char)(offset >> 8);
+
+    match_len -= MIN_MATCH;
+    if (match_len >= RUN_MASK) {
+        dst[token] |= RUN_MASK;
+        op = put_length(dst, op, match_len);
+    } else {
+        dst[token] |= (unsigned char)match_len;
+    }
+
+    return op;
+}
+
+size_t compress_block(const unsigned char *src, size_t src_len,
+                      unsigned char *dst, size_t dst_size) {
+    /* Position plus one of the last occurrence of each hash, 0 if none */
+    size_t table[HASH_SIZE];
+    size_t ip = 0;
+    size_t anchor = 0;
+    size_t op = 0;
+
+    memset(table, 0, sizeof(table));
+
+    while (src_len - ip >= MIN_MATCH && src_len >= MIN_MATCH) {
+        unsigned int h = hash4(src + ip);
+        size_t cand = table[h];
+        size_t len;
+
+        table[h] = ip + 1;
+
+        /* No match here */
+        if (!cand || ip - (cand - 1) > MAX_OFFSET ||
+            memcmp(src + cand - 1, src + ip, MIN_MATCH)) {
+            ip++;
+            continue;
+        }
+        cand--;
+
+        /* Extend the match (it may overlap the current position) */
+        for (len = MIN_MATCH; ip + len < src_len; len++) {
+            if (src[cand + len] != src[ip + len]) {
+                break;
+            }
+        }
+
+        op = put_sequence(src, anchor, ip - anchor, ip - cand, len, dst, op, dst_size);
+        if (!op) {
+            return 0;
+        }
+
+        /* Remember the end of the match too */
+        ip += len;
+        if (src_len - ip >= MIN_MATCH) {
+            table[hash4(src + ip - 2)] = ip - 2 + 1;
+        }
+        anchor = ip;
+    }
+
+    /* Trailing literals, always present even if empty */
+    op = put_sequence(src, anchor, src_len - anchor, 0, 0, dst, op, dst_size);
+
+    return op;
+}
+
+/* Read the extra bytes of a length, returning 0 on truncated input */
+static int get_length(const unsigned char *src, size_t src_len, size_t *ip, size_t *len) {
+    unsigned char b;
+
+    do {
+        if (*ip >= src_len) {
+            return 0;
+        }
+        b = src[(*ip)++];
+        *len += b;
+    } while (b == 255);
+
+    return 1;
+}
+
+long decompress_block(const unsigned char *src, size_t src_len,
+                      unsigned char *dst, size_t dst_size) {
+    size_t ip = 0;
+    size_t op = 0;
+
+    while (ip < src_len) {
+        unsigned char token = src[ip++];
+        size_t len = token >> 4;
+        size_t offset;
+
+        /* Literals */
+        if (len == RUN_MASK && !get_length(src, src_len, &ip, &len)) {
+            return -1;
+        }
+        if (len > src_len - ip || len > dst_size - op) {
+            return -1;
+        }
+        memcpy(dst + op, src + ip, len);
+        ip += len;
+        op += len;
+
+        /* The last sequence has no match */
+        if (ip == src_len) {
+            break;
+        }
+
+        /* Match */
+        if (src_len - ip < 2) {
+            return -1;
+        }
+        offset = (size_t)src[ip] | ((size_t)src[ip + 1] << 8);
+        ip += 2;
+
+        if (!offset || offset > op) {
+            return -1;
+        }
+
+        len = token & RUN_MASK;
+        if (len == RUN_MASK && !get_length(src, src_len, &ip, &len)) {
+            return -1;
+        }
+        len += MIN_MATCH;
+
+        if (len > dst_size - op) {
+            return -1;
+        }
+
+        /* Byte by byte, since the match may overlap its own output */
+        for (; len; len--, op++) {
+            dst[op] = dst[op - offset];
+        }
+    }
+
+    return (long)op;
+}
@@ -0,0 +1,46 @@
+/* File: compress.h */
+#ifndef INCLUDED_COMPRESS_H
+#define INCLUDED_COMPRESS_H
+
+#include <stddef.h>
+
+/*
+ * A small LZ77-style block compressor, used for the bulky parts of the
+ * savefile (the dungeon, objects and monsters).
+ *
+ * A block is a series of sequences, each made of a token byte (literal
+ * count in the high nibble, match length minus 4 in the low nibble, with
+ * 15 meaning "more length bytes follow"), the literals, and a two byte
+ * little-endian match offset.  The final sequence has literals only.
+ */
+
+/*
+ * Largest possible compressed size of a block
+ * @param len: Uncompressed size
+ */
+size_t compress_bound(size_t len);
+
+/*
+ * Compress a block
+ * @param src: Data to compress
+ * @param src_len: Size of the data
+ * @param dst: Output buffer
+ * @param dst_size: Size of the output buffer (compress_bound(src_len) is always enough)
+ * @return: Compressed size, or 0 if the output buffer is too small
+ */
+size_t compress_block(const unsigned char *src, size_t src_len,
+                      unsigned char *dst, size_t dst_size);
+
+/*
+ * Decompress a block
+ * Corrupt input is detected and never reads or writes out of bounds.
+ * @param src: Compressed data
+ * @param src_len: Size of the compressed data
+ * @param dst: Output buffer
+ * @param dst_size: Size of the output buffer
+ * @return: Decompressed size, or -1 if the data is corrupt or does not fit
+ */
+long decompress_block(const unsigned char *src, size_t src_len,
+                      unsigned char *dst, size_t dst_size);
+
+#endif /* INCLUDED_COMPRESS_H */
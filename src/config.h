@@ -257,26 +257,27 @@
  * OPTION: Delay the loading of the "k_text" array until it is actually
  * needed, saving ~1K, since "object" descriptions are unused.
  */
-/* #define DELAY_LOAD_K_TEXT */
+#define DELAY_LOAD_K_TEXT
 
 /*
  * OPTION: Delay the loading of the "a_text" array until it is actually
  * needed, saving ~1K, since "artifact" descriptions are unused.
  */
-/* #define DELAY_LOAD_A_TEXT */
+#define DELAY_LOAD_A_TEXT
 
 /*
  * OPTION: Delay the loading of the "e_text" array until it is actually
  * needed, saving ~1K, since "ego-item" descriptions are unused.
  */
-/* #define DELAY_LOAD_E_TEXT */
+#define DELAY_LOAD_E_TEXT
 
 
 /*
  * OPTION: Delay the loading of the "r_text" array until it is actually
- * needed, saving ~60K, but "simplifying" the "monster" descriptions.
+ * needed, saving ~60K, since only monster recall and the spoilers use the
+ * "monster" descriptions.  See "load_info_text()".
  */
-/* #define DELAY_LOAD_R_TEXT */
+#define DELAY_LOAD_R_TEXT
 
 /*
  * OPTION: Delay the loading of the "v_text" array until it is actually
@@ -59,6 +59,21 @@
 #define VERSION_EXTRA	0
 
 
+/*
+ * Current savefile version numbers
+ *
+ * These move on independently of the game version whenever the savefile
+ * format changes, so that "older_than()" can tell the formats apart.
+ *
+ * 0.2.3 -- the dungeon, objects and monsters are compressed
+ * 0.2.4 -- a plain summary chunk follows the version bytes
+ * 0.2.5 -- the other RNG streams follow the RNG state
+ */
+#define SAVEFILE_MAJOR	0
+#define SAVEFILE_MINOR	2
+#define SAVEFILE_PATCH	5
+
+
 /*
  * Version of random artifact code.
  */
@@ -118,6 +133,60 @@
 #define DUNGEON_WID		198
 
 
+/*
+ * Maximum number of remembered levels (see "level_cache.c")
+ */
+#define LEVEL_CACHE_MAX	16
+
+
+/*
+ * Phases of level generation timed by "gen_bench()"
+ */
+#define GEN_PHASE_ROOMS		0	/* room_build(), including vaults */
+#define GEN_PHASE_VAULTS	1	/* build_vault() */
+#define GEN_PHASE_TUNNELS	2	/* build_tunnel() and junction doors */
+#define GEN_PHASE_STREAMERS	3	/* build_streamer() */
+#define GEN_PHASE_OBJECTS	4	/* alloc_object() */
+#define GEN_PHASE_MONSTERS	5	/* alloc_monster() and quest monsters */
+#define GEN_PHASE_RETRY		6	/* Whole levels made and then rejected */
+#define GEN_PHASE_MAX		7
+
+/*
+ * Number of levels made by the level generation benchmark
+ */
+#define GEN_BENCH_LEVELS	2000
+
+
+/*
+ * Things placed on the grids of a vault (see "init_v_plan()")
+ */
+#define VAULT_TREASURE	1	/* '*' -- Object (75%) or trap */
+#define VAULT_TRAP		2	/* '^' -- Trap */
+#define VAULT_MONSTER	3	/* '&' -- Monster (5 levels out of depth) */
+#define VAULT_MEANER	4	/* '@' -- Monster (11 levels) */
+#define VAULT_GUARDED	5	/* '9' -- Monster (9 levels) and good object */
+#define VAULT_NASTY		6	/* '8' -- Monster (40 levels) and great object */
+#define VAULT_MAYBE		7	/* ',' -- Monster and/or object (50% each) */
+
+
+/*
+ * Maximum screen updates per second while running, resting or repeating
+ * a command (see "dungeon.c")
+ */
+#define FRAME_RATE_MAX	30
+
+/*
+ * Maximum redraws per second of the overhead map sub-windows at such times
+ */
+#define OVERHEAD_RATE_MAX	4
+
+
+/*
+ * Maximum number of grids in a queued projection animation (see "spells1.c")
+ */
+#define ANIM_GRIDS_MAX	2048
+
+
 /*
  * Maximum amount of Angband windows.
  */
@@ -2222,6 +2291,7 @@
  *   ITEM: Affect each object in the "blast area" in some way
  *   KILL: Affect each monster in the "blast area" in some way
  *   HIDE: Hack -- disable "visual" feedback from projection
+ *   ANIM: Hack -- only queue the "visual" feedback, with no effects
  */
 #define PROJECT_JUMP	0x01
 #define PROJECT_BEAM	0x02
@@ -2231,6 +2301,7 @@
 #define PROJECT_ITEM	0x20
 #define PROJECT_KILL	0x40
 #define PROJECT_HIDE	0x80
+#define PROJECT_ANIM	0x100
 
 
 /*
@@ -2339,8 +2410,9 @@
 /* xxx */
 #define PR_EXTRA		0x01000000L	/* Display Extra Info */
 #define PR_BASIC		0x02000000L	/* Display Basic Info */
-/* xxx */
+#define PR_SPOTS		0x04000000L	/* Display changed map grids */
 #define PR_MAP			0x08000000L	/* Display Map */
+#define PR_PANEL		0x10000000L	/* Display Map (the panel moved) */
 /* xxx (many) */
 
 /*
@@ -3209,8 +3281,8 @@ Beast-men
 #define OPT_auto_more				71
 #define OPT_smart_monsters			72
 #define OPT_smart_packs				73
-/* xxx */
-/* xxx */
+#define OPT_autosave_level			74
+#define OPT_persistent_levels		75
 /* xxx */
 /* xxx */
 /* xxx */
@@ -3327,8 +3399,8 @@ Beast-men
 #define auto_more				op_ptr->opt[OPT_auto_more]
 #define smart_monsters			op_ptr->opt[OPT_smart_monsters]
 #define smart_packs				op_ptr->opt[OPT_smart_packs]
-/* xxx */
-/* xxx */
+#define autosave_level			op_ptr->opt[OPT_autosave_level]
+#define persistent_levels		op_ptr->opt[OPT_persistent_levels]
 /* xxx */
 /* xxx */
 /* xxx */
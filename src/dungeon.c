@@ -10,6 +10,10 @@
 
 #include "angband.h"
 
+#include "profile.h"
+#include "trace.h"
+#include "replay.h"
+
 
 /*
  * Return a "feeling" (or NULL) about an item.  Method 1 (Heavy).
@@ -1887,6 +1891,36 @@ static void process_player_aux(void)
 }
 
 
+/*
+ * Decide whether to show the screen as it is now
+ *
+ * While the player is running, resting or repeating a command, the screen
+ * is updated at most FRAME_RATE_MAX times a second, since nobody can watch
+ * a long rest any faster, and redrawing after every turn makes such
+ * actions very slow on slow terminals.  The redraw flags are simply kept
+ * until the next frame.  As soon as anything disturbs the player, the
+ * action stops and every frame is shown again.
+ */
+static bool frame_due(void)
+{
+	static double last_frame = 0.0;
+
+	double now;
+
+	/* Single actions always show every frame */
+	if (!p_ptr->running && !p_ptr->resting && !p_ptr->command_rep) return (TRUE);
+
+	/* Too soon */
+	now = profile_now_ms();
+	if (now - last_frame < 1000.0 / FRAME_RATE_MAX) return (FALSE);
+
+	/* Show this one */
+	last_frame = now;
+
+	return (TRUE);
+}
+
+
 /*
  * Process the player
  *
@@ -1989,18 +2023,22 @@ static void process_player(void)
 		/* Update stuff (if needed) */
 		if (p_ptr->update) update_stuff();
 
-		/* Redraw stuff (if needed) */
-		if (p_ptr->redraw) redraw_stuff();
+		/* Show the frame, unless it is one too many */
+		if (frame_due())
+		{
+			/* Redraw stuff (if needed) */
+			if (p_ptr->redraw) redraw_stuff();
 
-		/* Redraw stuff (if needed) */
-		if (p_ptr->window) window_stuff();
+			/* Redraw stuff (if needed) */
+			if (p_ptr->window) window_stuff();
 
 
-		/* Place the cursor on the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
+			/* Place the cursor on the player */
+			move_cursor_relative(p_ptr->py, p_ptr->px);
 
-		/* Refresh (optional) */
-		if (fresh_before) Term_fresh();
+			/* Refresh (optional) */
+			if (fresh_before) Term_fresh();
+		}
 
 
 		/* Hack -- Pack Overflow */
@@ -2172,7 +2210,7 @@ static void process_player(void)
 					shimmer_monsters = TRUE;
 
 					/* Redraw regardless */
-					lite_spot(m_ptr->fy, m_ptr->fx);
+					dirty_spot(m_ptr->fy, m_ptr->fx);
 				}
 			}
 
@@ -2265,6 +2303,105 @@ static void process_player(void)
 
 
 
+/*
+ * Fold the state of the game at the end of a turn into "state_checksum"
+ *
+ * Only the things that drive the game forward are included -- the random
+ * number generator, the player's position and vital statistics, and the
+ * live monsters and objects -- field by field, so that the checksum does
+ * not depend on structure padding.  Two builds which play the same turns
+ * from the same savefile with the same keys should get the same checksums.
+ *
+ * This scans the whole state, so it is only done while a trace is being
+ * written (see "trace.c"), which is the only thing that reads the checksum.
+ */
+static void update_state_checksum(void)
+{
+	unsigned long h = state_checksum;
+	int i, s;
+
+	/* The time */
+	h = trace_hash_u32(h, (u32b)turn);
+
+	/* The random number generator */
+	h = trace_hash_u32(h, Rand_place);
+	h = trace_hash_u32(h, Rand_value);
+	h = trace_hash_u32(h, Rand_mode);
+	h = trace_hash_u32(h, Rand_stream);
+	for (i = 0; i < RAND_DEG; i++) h = trace_hash_u32(h, Rand_state[i]);
+	for (s = 0; s < RAND_STREAM_MAX; s++)
+	{
+		h = trace_hash_u32(h, Rand_stream_place[s]);
+		for (i = 0; i < RAND_DEG; i++)
+		{
+			h = trace_hash_u32(h, Rand_stream_state[s][i]);
+		}
+	}
+
+	/* The player */
+	h = trace_hash_u32(h, (u32b)p_ptr->depth);
+	h = trace_hash_u32(h, (u32b)p_ptr->py);
+	h = trace_hash_u32(h, (u32b)p_ptr->px);
+	h = trace_hash_u32(h, (u32b)p_ptr->chp);
+	h = trace_hash_u32(h, (u32b)p_ptr->chp_frac);
+	h = trace_hash_u32(h, (u32b)p_ptr->csp);
+	h = trace_hash_u32(h, (u32b)p_ptr->energy);
+	h = trace_hash_u32(h, (u32b)p_ptr->exp);
+	h = trace_hash_u32(h, (u32b)p_ptr->au);
+	h = trace_hash_u32(h, (u32b)p_ptr->food);
+
+	/* The monsters */
+	for (i = 1; i < m_max; i++)
+	{
+		monster_type *m_ptr = &m_list[i];
+
+		/* Skip dead monsters */
+		if (!m_ptr->r_idx) continue;
+
+		h = trace_hash_u32(h, (u32b)i);
+		h = trace_hash_u32(h, (u32b)m_ptr->r_idx);
+		h = trace_hash_u32(h, (u32b)m_ptr->fy);
+		h = trace_hash_u32(h, (u32b)m_ptr->fx);
+		h = trace_hash_u32(h, (u32b)m_ptr->hp);
+		h = trace_hash_u32(h, (u32b)m_ptr->maxhp);
+		h = trace_hash_u32(h, (u32b)m_ptr->csleep);
+		h = trace_hash_u32(h, (u32b)m_ptr->mspeed);
+		h = trace_hash_u32(h, (u32b)m_ptr->energy);
+		h = trace_hash_u32(h, (u32b)m_ptr->stunned);
+		h = trace_hash_u32(h, (u32b)m_ptr->confused);
+		h = trace_hash_u32(h, (u32b)m_ptr->monfear);
+		h = trace_hash_u32(h, (u32b)m_ptr->hold_o_idx);
+	}
+
+	/* The objects */
+	for (i = 1; i < o_max; i++)
+	{
+		object_type *o_ptr = &o_list[i];
+
+		/* Skip dead objects */
+		if (!o_ptr->k_idx) continue;
+
+		h = trace_hash_u32(h, (u32b)i);
+		h = trace_hash_u32(h, (u32b)o_ptr->k_idx);
+		h = trace_hash_u32(h, (u32b)o_ptr->iy);
+		h = trace_hash_u32(h, (u32b)o_ptr->ix);
+		h = trace_hash_u32(h, (u32b)o_ptr->number);
+		h = trace_hash_u32(h, (u32b)o_ptr->pval);
+		h = trace_hash_u32(h, (u32b)o_ptr->timeout);
+		h = trace_hash_u32(h, (u32b)o_ptr->name1);
+		h = trace_hash_u32(h, (u32b)o_ptr->name2);
+		h = trace_hash_u32(h, (u32b)o_ptr->next_o_idx);
+		h = trace_hash_u32(h, (u32b)o_ptr->held_m_idx);
+	}
+
+	state_checksum = (u32b)h;
+
+	/* Write it to the trace, if any */
+	trace_record((long)turn, state_checksum);
+}
+
+
+
 /*
  * Interact with the current dungeon level.
  *
@@ -2457,6 +2594,10 @@ static void dungeon(void)
 	if (p_ptr->is_dead) return;
 
 
+	/* Autosave freshly generated levels */
+	if (autosave_level && (turn == old_turn)) do_cmd_autosave();
+
+
 	/* Announce (or repeat) the feeling */
 	if (p_ptr->depth) do_cmd_feeling();
 
@@ -2525,17 +2666,21 @@ static void dungeon(void)
 		/* Update stuff */
 		if (p_ptr->update) update_stuff();
 
-		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff();
+		/* Show the frame, unless it is one too many */
+		if (frame_due())
+		{
+			/* Redraw stuff */
+			if (p_ptr->redraw) redraw_stuff();
 
-		/* Redraw stuff */
-		if (p_ptr->window) window_stuff();
+			/* Redraw stuff */
+			if (p_ptr->window) window_stuff();
 
-		/* Hack -- Hilite the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
+			/* Hack -- Hilite the player */
+			move_cursor_relative(p_ptr->py, p_ptr->px);
 
-		/* Optional fresh */
-		if (fresh_after) Term_fresh();
+			/* Optional fresh */
+			if (fresh_after) Term_fresh();
+		}
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving) break;
@@ -2552,17 +2697,21 @@ static void dungeon(void)
 		/* Update stuff */
 		if (p_ptr->update) update_stuff();
 
-		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff();
+		/* Show the frame, unless it is one too many */
+		if (frame_due())
+		{
+			/* Redraw stuff */
+			if (p_ptr->redraw) redraw_stuff();
 
-		/* Redraw stuff */
-		if (p_ptr->window) window_stuff();
+			/* Redraw stuff */
+			if (p_ptr->window) window_stuff();
 
-		/* Hack -- Hilite the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
+			/* Hack -- Hilite the player */
+			move_cursor_relative(p_ptr->py, p_ptr->px);
 
-		/* Optional fresh */
-		if (fresh_after) Term_fresh();
+			/* Optional fresh */
+			if (fresh_after) Term_fresh();
+		}
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving) break;
@@ -2577,17 +2726,21 @@ static void dungeon(void)
 		/* Update stuff */
 		if (p_ptr->update) update_stuff();
 
-		/* Redraw stuff */
-		if (p_ptr->redraw) redraw_stuff();
+		/* Show the frame, unless it is one too many */
+		if (frame_due())
+		{
+			/* Redraw stuff */
+			if (p_ptr->redraw) redraw_stuff();
 
-		/* Window stuff */
-		if (p_ptr->window) window_stuff();
+			/* Window stuff */
+			if (p_ptr->window) window_stuff();
 
-		/* Hack -- Hilite the player */
-		move_cursor_relative(p_ptr->py, p_ptr->px);
+			/* Hack -- Hilite the player */
+			move_cursor_relative(p_ptr->py, p_ptr->px);
 
-		/* Optional fresh */
-		if (fresh_after) Term_fresh();
+			/* Optional fresh */
+			if (fresh_after) Term_fresh();
+		}
 
 		/* Handle "leaving" */
 		if (p_ptr->leaving) break;
@@ -2595,6 +2748,9 @@ static void dungeon(void)
 
 		/* Count game turns */
 		turn++;
+
+		/* Checksum the game state, if anyone is looking */
+		if (trace_active()) update_state_checksum();
 	}
 }
 
@@ -2619,6 +2775,42 @@ static void process_some_user_pref_files(void)
 }
 
 
+/*
+ * Record the state of the random number generator in a recording of the
+ * keys, or restore it from one being played back
+ */
+static void replay_sync_rng(void)
+{
+	unsigned long words[RAND_DEG + 2];
+	int i;
+
+	/* Collect the state (the algorithm is zero in older recordings) */
+	words[0] = Rand_value;
+	words[1] = Rand_place | ((unsigned long)Rand_mode << 16);
+	for (i = 0; i < RAND_DEG; i++) words[i + 2] = Rand_state[i];
+
+	/* Record it, or read it back */
+	if (replay_rng(words, RAND_DEG + 2))
+	{
+		quit("replay file does not match this game");
+	}
+
+	/* Restore it */
+	Rand_value = (u32b)words[0];
+	Rand_place = (u16b)(words[1] & 0xFFFF);
+	Rand_mode = (u16b)(words[1] >> 16);
+	if (Rand_mode >= RAND_MODE_MAX) Rand_mode = RAND_MODE_LEGACY;
+	for (i = 0; i < RAND_DEG; i++) Rand_state[i] = (u32b)words[i + 2];
+
+	/* Hack -- the other streams start over from the main one */
+	if (replay_recording() || replay_playing())
+	{
+		Rand_stream = RAND_STREAM_MAIN;
+		Rand_streams_init(Rand_state[0] ^ Rand_state[RAND_DEG - 1]);
+	}
+}
+
+
 /*
  * Actually play a game.
  *
@@ -2678,12 +2870,28 @@ void play_game(bool new_game)
 	(void)Term_set_cursor(0);
 
 
+	/* Play back recorded keys, or record them, if requested */
+	if (getenv("STEAMBAND_REPLAY"))
+	{
+		if (replay_play_start(getenv("STEAMBAND_REPLAY")))
+		{
+			quit("cannot read replay file");
+		}
+	}
+	else if (getenv("STEAMBAND_RECORD"))
+	{
+		(void)replay_record_start(getenv("STEAMBAND_RECORD"));
+	}
+
+
 	/* Attempt to load */
+	profile_begin("load_player");
 	if (!load_player())
 	{
 		/* Oops */
 		quit("broken savefile");
 	}
+	profile_end();
 
 	/* Nothing loaded */
 	if (!character_loaded)
@@ -2719,10 +2927,21 @@ void play_game(bool new_game)
 		/* Use the complex RNG */
 		Rand_quick = FALSE;
 
-		/* Seed the "complex" RNG */
+		/* New characters get the fast algorithm, unless asked not to */
+		Rand_mode = RAND_MODE_FAST;
+		if (getenv("STEAMBAND_RNG") && streq(getenv("STEAMBAND_RNG"), "legacy"))
+		{
+			Rand_mode = RAND_MODE_LEGACY;
+		}
+
+		/* Seed the "complex" RNG, and its other streams */
 		Rand_state_init(seed);
+		Rand_streams_init(seed);
 	}
 
+	/* Hack -- replays start from the same RNG state */
+	replay_sync_rng();
+
 	/* Roll new character */
 	if (new_game)
 	{
@@ -2808,7 +3027,9 @@ void play_game(bool new_game)
 
 
 	/* Process some user pref files */
+	profile_begin("user pref files");
 	process_some_user_pref_files();
+	profile_end();
 
 
 	/* Set or clear "rogue_like_commands" if requested */
@@ -2821,7 +3042,28 @@ void play_game(bool new_game)
 
 
 	/* Generate a dungeon level if needed */
+	profile_begin("generate_cave");
 	if (!character_dungeon) generate_cave();
+	profile_end();
+
+
+	/* Benchmark level generation and quit, if requested */
+	if (getenv("STEAMBAND_GEN_BENCH"))
+	{
+		cptr levels = getenv("STEAMBAND_GEN_BENCH_LEVELS");
+
+		(void)gen_bench(getenv("STEAMBAND_GEN_BENCH"),
+		                levels ? atoi(levels) : GEN_BENCH_LEVELS);
+		quit(NULL);
+	}
+
+
+	/* Report startup timings (and dump them, if requested) */
+	(void)profile_report(getenv("STEAMBAND_STARTUP_PROFILE"));
+
+	/* Trace the game state checksums, if requested */
+	(void)trace_open(getenv("STEAMBAND_TRACE"));
+	state_checksum = TRACE_HASH_INIT;
 
 
 	/* Character is now "complete" */
@@ -2838,9 +3080,15 @@ void play_game(bool new_game)
 	/* Hack -- Enforce "delayed death" */
 	if (p_ptr->chp < 0) p_ptr->is_dead = TRUE;
 
+	/* No levels remembered yet */
+	level_cache_wipe();
+
 	/* Process */
 	while (TRUE)
 	{
+		/* Depth of the level being played */
+		int depth = p_ptr->depth;
+
 		/* Process the level */
 		dungeon();
 
@@ -2873,6 +3121,12 @@ void play_game(bool new_game)
 		if (!p_ptr->playing && !p_ptr->is_dead) break;
 
 
+		/* Remember the old cave, if going to another depth */
+		if (persistent_levels && !p_ptr->is_dead && (p_ptr->depth != depth))
+		{
+			level_cache_store(depth);
+		}
+
 		/* Erase the old cave */
 		wipe_o_list();
 		wipe_m_list();
@@ -2953,6 +3207,10 @@ void play_game(bool new_game)
 		generate_cave();
 	}
 
+	/* Finish the trace and any recording */
+	trace_close();
+	replay_close();
+
 	/* Close stuff */
 	close_game();
 }
@@ -100,10 +100,17 @@ extern s16b monster_level;
 extern char summon_kin_type;
 extern s32b turn;
 extern s32b old_turn;
+extern u32b state_checksum;
+extern gen_stats_type *gen_stats;
+extern u32b map_frames;
+extern u32b map_grids;
+extern u16b map_grids_last;
+extern u32b map_changes;
 extern bool use_sound;
 extern bool use_graphics;
 extern s16b signal_count;
 extern bool msg_flag;
+extern bool msg_silent;
 extern bool inkey_base;
 extern bool inkey_xtra;
 extern bool inkey_scan;
@@ -174,6 +181,7 @@ extern player_type *p_ptr;
 extern vault_type *v_info;
 extern char *v_name;
 extern char *v_text;
+extern vault_plan *v_plan;
 extern feature_type *f_info;
 extern char *f_name;
 extern char *f_text;
@@ -255,6 +263,9 @@ extern void move_cursor_relative(int y, int x);
 extern void print_rel(char c, byte a, int y, int x);
 extern void note_spot(int y, int x);
 extern void lite_spot(int y, int x);
+extern void map_memo_forget(void);
+extern void dirty_spot(int y, int x);
+extern void prt_dirty_spots(void);
 extern void prt_map(void);
 extern void display_map(int *cy, int *cx);
 extern void do_cmd_view_map(void);
@@ -394,6 +405,7 @@ extern void process_player_name(bool sf);
 extern void get_name(void);
 extern void do_cmd_suicide(void);
 extern void do_cmd_save_game(void);
+extern void do_cmd_autosave(void);
 extern long total_points(void);
 extern void display_scores(int from, int to);
 extern errr predict_score(void);
@@ -404,12 +416,16 @@ extern void signals_handle_tstp(void);
 extern void signals_init(void);
 extern void display_scores_aux(int from, int to, int note, high_score *score);
 
+/* gen_bench.c */
+extern errr gen_bench(cptr path, int levels);
+
 /* generate.c */
 extern void generate_cave(void);
 
 /* init2.c */
 extern void init_file_paths(char *path);
 extern void init_angband(void);
+extern errr load_info_text(char **text);
 extern void cleanup_angband(void);
 
 /* load1.c */
@@ -419,6 +435,12 @@ extern errr rd_savefile_old(void);
  
 /* level.c */
 extern void level_reward(void);
+
+/* level_cache.c */
+extern void level_cache_wipe(void);
+extern void level_cache_store(int depth);
+extern bool level_cache_load(int depth, bool *spare);
+extern bool level_cache_spare(void);
  
 /* load2.c */
 extern errr rd_savefile_new(void);
@@ -571,8 +593,16 @@ extern void monster_drop_carried_objects(monster_type *m_ptr);
 
 /* save.c */
 extern bool save_player(void);
+extern bool save_player_wait(void);
+extern bool autosave_player(void);
 extern bool load_player(void);
 
+/* snapshot.c */
+extern snapshot_type *snapshot_take(void);
+extern bool snapshot_restore(const snapshot_type *s_ptr);
+extern bool snapshot_same(const snapshot_type *s_ptr, const snapshot_type *t_ptr);
+extern void snapshot_free(snapshot_type *s_ptr);
+
 /* spells1.c */
 extern s16b poly_r_idx(int r_idx);
 extern void teleport_away(int m_idx, int dis);
@@ -589,6 +619,8 @@ extern bool inc_stat(int stat);
 extern bool dec_stat(int stat, int amount, int permanent);
 extern bool res_stat(int stat);
 extern bool apply_disenchant(int mode);
+extern void anim_batch_begin(void);
+extern void anim_batch_end(void);
 extern bool project(int who, int rad, int y, int x, int dam, int typ, int flg);
 
 /* spells2.c */
@@ -722,6 +754,8 @@ extern errr message_color_define(u16b type, byte color);
 extern void message_add(cptr str, u16b type);
 extern errr messages_init(void);
 extern void messages_free(void);
+extern byte *messages_copy(void);
+extern void messages_restore(byte *buf);
 extern void move_cursor(int row, int col);
 extern void msg_print(cptr msg);
 extern void msg_format(cptr fmt, ...);
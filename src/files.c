@@ -1309,19 +1309,19 @@ static void display_player_xtra_info(void)
 	if (p_ptr->exp >= p_ptr->max_exp)
 	{
 		Term_putstr(col+8, 11, -1, TERM_L_GREEN,
-		            format("%10ld", p_ptr->exp));
+		            format("%10ld", (long)p_ptr->exp));
 	}
 	else
 	{
 		Term_putstr(col+8, 11, -1, TERM_YELLOW,
-		            format("%10ld", p_ptr->exp));
+		            format("%10ld", (long)p_ptr->exp));
 	}
 
 
 	/* Maximum Experience */
 	Term_putstr(col, 12, -1, TERM_WHITE, "Max Exp");
 	Term_putstr(col+8, 12, -1, TERM_L_GREEN,
-	            format("%10ld", p_ptr->max_exp));
+	            format("%10ld", (long)p_ptr->max_exp));
 
 
 	/* Advance Experience -> next level * expfact / 100L */
@@ -1331,7 +1331,7 @@ static void display_player_xtra_info(void)
 		s32b advance = (player_exp[p_ptr->lev - 1] *
 		                p_ptr->expfact / 100L);
 		Term_putstr(col+8, 13, -1, TERM_L_GREEN,
-		            format("%10ld", advance));
+		            format("%10ld", (long)advance));
 	}
 	else
 	{
@@ -1343,13 +1343,13 @@ static void display_player_xtra_info(void)
 	/* Gold */
 	Term_putstr(col, 15, -1, TERM_WHITE, "Gold");
 	Term_putstr(col+8, 15, -1, TERM_L_GREEN,
-	            format("%10ld", p_ptr->au));
+	            format("%10ld", (long)p_ptr->au));
 
 
 	/* Burden */
 	sprintf(buf, "%ld.%ld lbs",
-	        p_ptr->total_weight / 10,
-	        p_ptr->total_weight % 10);
+	        (long)(p_ptr->total_weight / 10),
+	        (long)(p_ptr->total_weight % 10));
 	Term_putstr(col, 17, -1, TERM_WHITE, "Burden");
 	Term_putstr(col+8, 17, -1, TERM_L_GREEN,
 	            format("%10s", buf));
@@ -2108,7 +2108,7 @@ errr file_character(cptr name, bool full)
 		fd_close(fd);
 
 		/* Build query */
-		sprintf(out_val, "Replace existing file %s? ", buf);
+		strnfmt(out_val, sizeof(out_val), "Replace existing file %s? ", buf);
 
 		/* Ask */
 		if (get_check(out_val)) fd = -1;
@@ -2973,6 +2973,22 @@ void do_cmd_save_game(void)
 }
 
 
+/*
+ * Save the game without interrupting play
+ */
+void do_cmd_autosave(void)
+{
+	/* The player is not dead */
+	strcpy(p_ptr->died_from, "(saved)");
+
+	/* Save the player in the background */
+	if (!autosave_player()) msg_print("Autosave failed!");
+
+	/* Note that the player is not dead */
+	strcpy(p_ptr->died_from, "(alive and well)");
+}
+
+
 
 /*
  * Hack -- Calculates the total number of points earned
@@ -3614,7 +3630,7 @@ void display_scores_aux(int from, int to, int note, high_score *score)
 			c_put_str(attr, out_val, n*4 + 3, 0);
 
 			/* And still another line of info */
-			sprintf(out_val,
+			strnfmt(out_val, sizeof(out_val),
 			        "               (User %s, Date %s, Gold %s, Turn %s).",
 			        user, when, gold, aged);
 			c_put_str(attr, out_val, n*4 + 4, 0);
@@ -3791,14 +3807,16 @@ static errr enter_score(void)
 	/* Save the player info XXX XXX XXX */
 	sprintf(the_score.uid, "%7u", player_uid);
 	sprintf(the_score.sex, "%c", (p_ptr->psex ? 'm' : 'f'));
-	sprintf(the_score.p_r, "%2d", p_ptr->prace);
-	sprintf(the_score.p_c, "%2d", p_ptr->pclass);
+	strnfmt(the_score.p_r, sizeof(the_score.p_r), "%2d", p_ptr->prace);
+	strnfmt(the_score.p_c, sizeof(the_score.p_c), "%2d", p_ptr->pclass);
 
 	/* Save the level and such */
-	sprintf(the_score.cur_lev, "%3d", p_ptr->lev);
-	sprintf(the_score.cur_dun, "%3d", p_ptr->depth);
-	sprintf(the_score.max_lev, "%3d", p_ptr->max_lev);
-	sprintf(the_score.max_dun, "%3d", p_ptr->max_depth);
+	strnfmt(the_score.cur_lev, sizeof(the_score.cur_lev), "%3d", p_ptr->lev);
+	strnfmt(the_score.cur_dun, sizeof(the_score.cur_dun), "%3d", p_ptr->depth);
+	strnfmt(the_score.max_lev, sizeof(the_score.max_lev), "%3d",
+	        p_ptr->max_lev);
+	strnfmt(the_score.max_dun, sizeof(the_score.max_dun), "%3d",
+	        p_ptr->max_depth);
 
 	/* Save the cause of death (31 chars) */
 	sprintf(the_score.how, "%-.31s", p_ptr->died_from);
@@ -3915,14 +3933,16 @@ errr predict_score(void)
 	/* Save the player info XXX XXX XXX */
 	sprintf(the_score.uid, "%7u", player_uid);
 	sprintf(the_score.sex, "%c", (p_ptr->psex ? 'm' : 'f'));
-	sprintf(the_score.p_r, "%2d", p_ptr->prace);
-	sprintf(the_score.p_c, "%2d", p_ptr->pclass);
+	strnfmt(the_score.p_r, sizeof(the_score.p_r), "%2d", p_ptr->prace);
+	strnfmt(the_score.p_c, sizeof(the_score.p_c), "%2d", p_ptr->pclass);
 
 	/* Save the level and such */
-	sprintf(the_score.cur_lev, "%3d", p_ptr->lev);
-	sprintf(the_score.cur_dun, "%3d", p_ptr->depth);
-	sprintf(the_score.max_lev, "%3d", p_ptr->max_lev);
-	sprintf(the_score.max_dun, "%3d", p_ptr->max_depth);
+	strnfmt(the_score.cur_lev, sizeof(the_score.cur_lev), "%3d", p_ptr->lev);
+	strnfmt(the_score.cur_dun, sizeof(the_score.cur_dun), "%3d", p_ptr->depth);
+	strnfmt(the_score.max_lev, sizeof(the_score.max_lev), "%3d",
+	        p_ptr->max_lev);
+	strnfmt(the_score.max_dun, sizeof(the_score.max_dun), "%3d",
+	        p_ptr->max_depth);
 
 	/* Hack -- no cause of death */
 	strcpy(the_score.how, "nobody (yet!)");
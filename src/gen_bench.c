@@ -0,0 +1,271 @@
+/* File: gen_bench.c */
+
+/*
+ * Purpose: benchmark level generation
+ *
+ * "gen_bench()" makes a great many dungeon levels, one after another,
+ * each from a seed of its own, and times the phases of "cave_gen()" as it
+ * goes (see "gen_stats" in "generate.c").  Each level is written as one
+ * line of a CSV report, so the seeds that make descending stutter can be
+ * found and made again, and a summary of the times and of the spread of
+ * room, vault, retry, object and monster counts goes to the log.
+ *
+ * It can be run from the debug commands, or without a player at the keys
+ * by naming the report in "STEAMBAND_GEN_BENCH" (see "play_game()").
+ */
+
+#include "angband.h"
+
+#include "logging.h"
+#include "profile.h"
+
+
+/*
+ * Number of the slowest levels listed in the log
+ */
+#define GEN_BENCH_SLOWEST	10
+
+
+/*
+ * Names of the phases of level generation, in the order of GEN_PHASE_*
+ */
+static cptr gen_phase_name[GEN_PHASE_MAX] =
+{
+	"rooms",
+	"vaults",
+	"tunnels",
+	"streamers",
+	"objects",
+	"monsters",
+	"retry"
+};
+
+
+/*
+ * Sort counts into increasing order
+ */
+static int gen_bench_cmp_count(const void *a, const void *b)
+{
+	return (*(const s16b *)a - *(const s16b *)b);
+}
+
+
+/*
+ * Sort levels into order, slowest first
+ */
+static int gen_bench_cmp_total(const void *a, const void *b)
+{
+	const gen_stats_type *g1 = (const gen_stats_type *)a;
+	const gen_stats_type *g2 = (const gen_stats_type *)b;
+
+	if (g1->total > g2->total) return (-1);
+	if (g1->total < g2->total) return (1);
+	return (0);
+}
+
+
+/*
+ * Log the spread of one count over all the levels
+ */
+static void gen_bench_spread(cptr what, s16b *vals, int n)
+{
+	long sum = 0L;
+
+	int i;
+
+
+	/* Sort the counts */
+	qsort(vals, n, sizeof(s16b), gen_bench_cmp_count);
+
+	/* Add them up */
+	for (i = 0; i < n; i++) sum += vals[i];
+
+	LOG_I("Level generation: %-9s min %d, median %d, 95%% %d, 99%% %d, "
+	      "max %d, mean %.2f", what, vals[0], vals[n / 2],
+	      vals[(n * 95) / 100], vals[(n * 99) / 100], vals[n - 1],
+	      (double)sum / n);
+}
+
+
+/*
+ * Make "levels" levels and report how long each part of each one took
+ *
+ * Every level is made from the same situation (a snapshot of the current
+ * one), at depths 1 to MAX_DEPTH-1 in turn, with the level generation
+ * stream seeded by the number of the level (starting at 1).  The current
+ * level is put back afterwards, but the remembered levels are forgotten.
+ *
+ * The report is written to "path", unless it is NULL.
+ */
+errr gen_bench(cptr path, int levels)
+{
+	gen_stats_type *list, *g_ptr;
+
+	snapshot_type *s_ptr;
+
+	FILE *fff = NULL;
+
+	s16b *vals;
+
+	int i, n, old_stream;
+
+	double start, all = 0.0;
+
+	double sum[GEN_PHASE_MAX], most[GEN_PHASE_MAX];
+
+	bool old_auto_more = auto_more;
+
+
+	/* Paranoia */
+	if (levels < 1) return (-1);
+
+	/* Open the report */
+	if (path)
+	{
+		fff = my_fopen(path, "w");
+
+		if (!fff)
+		{
+			LOG_W("Cannot write the level generation report %s", path);
+			return (-1);
+		}
+	}
+
+	/* Room for the statistics */
+	C_MAKE(list, levels, gen_stats_type);
+	C_MAKE(vals, levels, s16b);
+
+	/* Do not stop for messages */
+	auto_more = TRUE;
+
+	/* Make new levels, not remembered or spare ones */
+	level_cache_wipe();
+
+	/* Snapshot the situation */
+	s_ptr = snapshot_take();
+
+	/* Make the levels */
+	for (i = 0; i < levels; i++)
+	{
+		g_ptr = &list[i];
+
+		/* Go back to the start */
+		(void)snapshot_restore(s_ptr);
+
+		/* Leave the current level */
+		wipe_o_list();
+		wipe_m_list();
+
+		/* Every depth in turn, each level from its own seed */
+		g_ptr->depth = 1 + (i % (MAX_DEPTH - 1));
+		g_ptr->seed = (u32b)(i + 1);
+		p_ptr->depth = g_ptr->depth;
+
+		/* Seed the level generation stream */
+		old_stream = Rand_stream_set(RAND_STREAM_GEN);
+		Rand_place = 0;
+		Rand_state_init(g_ptr->seed);
+		(void)Rand_stream_set(old_stream);
+
+		/* Make the level, counting */
+		gen_stats = g_ptr;
+		start = profile_now_ms();
+		generate_cave();
+		g_ptr->total = profile_now_ms() - start;
+		gen_stats = NULL;
+	}
+
+	/* Leave things as they were */
+	(void)snapshot_restore(s_ptr);
+	snapshot_free(s_ptr);
+
+	auto_more = old_auto_more;
+
+
+	/* One line per level */
+	if (fff)
+	{
+		fprintf(fff, "seed,depth,total_ms");
+		for (n = 0; n < GEN_PHASE_MAX; n++)
+		{
+			fprintf(fff, ",%s_ms", gen_phase_name[n]);
+		}
+		fprintf(fff, ",rooms,vaults,retries,objects,monsters\n");
+
+		for (i = 0; i < levels; i++)
+		{
+			g_ptr = &list[i];
+
+			fprintf(fff, "%lu,%d,%.3f", (unsigned long)g_ptr->seed,
+			        g_ptr->depth, g_ptr->total);
+			for (n = 0; n < GEN_PHASE_MAX; n++)
+			{
+				fprintf(fff, ",%.3f", g_ptr->ms[n]);
+			}
+			fprintf(fff, ",%d,%d,%d,%d,%d\n", g_ptr->rooms, g_ptr->vaults,
+			        g_ptr->retries, g_ptr->objects, g_ptr->monsters);
+		}
+
+		my_fclose(fff);
+	}
+
+
+	/* Add up the phases */
+	for (n = 0; n < GEN_PHASE_MAX; n++) sum[n] = most[n] = 0.0;
+	for (i = 0; i < levels; i++)
+	{
+		g_ptr = &list[i];
+
+		all += g_ptr->total;
+
+		for (n = 0; n < GEN_PHASE_MAX; n++)
+		{
+			sum[n] += g_ptr->ms[n];
+			if (g_ptr->ms[n] > most[n]) most[n] = g_ptr->ms[n];
+		}
+	}
+
+	LOG_I("Level generation: %d levels in %.1f ms, %.3f ms each",
+	      levels, all, all / levels);
+	for (n = 0; n < GEN_PHASE_MAX; n++)
+	{
+		LOG_I("Level generation: %-9s %.3f ms mean, %.3f ms max",
+		      gen_phase_name[n], sum[n] / levels, most[n]);
+	}
+
+	/* The spread of each count */
+	for (i = 0; i < levels; i++) vals[i] = list[i].rooms;
+	gen_bench_spread("rooms", vals, levels);
+	for (i = 0; i < levels; i++) vals[i] = list[i].vaults;
+	gen_bench_spread("vaults", vals, levels);
+	for (i = 0; i < levels; i++) vals[i] = list[i].retries;
+	gen_bench_spread("retries", vals, levels);
+	for (i = 0; i < levels; i++) vals[i] = list[i].objects;
+	gen_bench_spread("objects", vals, levels);
+	for (i = 0; i < levels; i++) vals[i] = list[i].monsters;
+	gen_bench_spread("monsters", vals, levels);
+
+	/* The slowest levels */
+	qsort(list, levels, sizeof(gen_stats_type), gen_bench_cmp_total);
+
+	LOG_I("Level generation: median %.3f ms, 99%% %.3f ms, max %.3f ms",
+	      list[levels / 2].total, list[levels / 100].total, list[0].total);
+	for (i = 0; (i < levels) && (i < GEN_BENCH_SLOWEST); i++)
+	{
+		g_ptr = &list[i];
+
+		LOG_I("Level generation: seed %lu depth %d took %.3f ms "
+		      "(rooms %.3f, vaults %.3f, retry %.3f; %d rooms, %d vaults, "
+		      "%d retries)", (unsigned long)g_ptr->seed, g_ptr->depth,
+		      g_ptr->total, g_ptr->ms[GEN_PHASE_ROOMS],
+		      g_ptr->ms[GEN_PHASE_VAULTS], g_ptr->ms[GEN_PHASE_RETRY],
+		      g_ptr->rooms, g_ptr->vaults, g_ptr->retries);
+	}
+
+	/* Free the statistics */
+	C_KILL(vals, levels, s16b);
+	C_KILL(list, levels, gen_stats_type);
+
+	/* Success */
+	return (0);
+}
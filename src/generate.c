@@ -10,6 +10,8 @@
 
 #include "angband.h"
 
+#include "profile.h"
+
 
 /*
  * Note that Level generation is *not* an important bottleneck,
@@ -245,6 +247,25 @@ struct dun_data
 static dun_data *dun;
 
 
+/*
+ * Start timing a phase of level generation (see "gen_bench()")
+ */
+static double gen_phase_start(void)
+{
+	/* Only when someone is counting */
+	return (gen_stats ? profile_now_ms() : 0.0);
+}
+
+
+/*
+ * Add the time since "start" to a phase of level generation
+ */
+static void gen_phase_end(int phase, double start)
+{
+	if (gen_stats) gen_stats->ms[phase] += profile_now_ms() - start;
+}
+
+
 /*
  * Array of room types (assumes 11x11 blocks)
  */
@@ -481,6 +502,8 @@ static void alloc_object(int set, int typ, int num)
 {
 	int y, x, k;
 
+	double start = gen_phase_start();
+
 	/* Place some objects */
 	for (k = 0; k < num; k++)
 	{
@@ -537,6 +560,8 @@ static void alloc_object(int set, int typ, int num)
 			}
 		}
 	}
+
+	gen_phase_end(GEN_PHASE_OBJECTS, start);
 }
 
 
@@ -2132,165 +2157,140 @@ static void build_type6(int y0, int x0)
 
 /*
  * Hack -- fill in "vault" rooms
+ *
+ * The vault comes ready compiled into lists of grids (see "init_v_plan()").
  */
-static void build_vault(int y0, int x0, int ymax, int xmax, cptr data)
+static void build_vault(int y0, int x0, const vault_type *v_ptr)
 {
-	int dx, dy, x, y;
+	const vault_plan *vp_ptr = &v_plan[v_ptr - v_info];
 
-	cptr t;
+	const vault_grid *g_ptr;
 
+	int i, n, x, y;
 
-	/* Place dungeon features and objects */
-	for (t = data, dy = 0; dy < ymax; dy++)
-	{
-		for (dx = 0; dx < xmax; dx++, t++)
-		{
-			/* Extract the location */
-			x = x0 - (xmax / 2) + dx;
-			y = y0 - (ymax / 2) + dy;
+	/* The top left corner */
+	int y1 = y0 - (v_ptr->hgt / 2);
+	int x1 = x0 - (v_ptr->wid / 2);
 
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
+	double start = gen_phase_start();
 
-			/* Lay down a floor */
-			cave_set_feat(y, x, FEAT_FLOOR);
 
-			/* Part of a vault */
-			cave_info[y][x] |= (CAVE_ROOM | CAVE_ICKY);
+	/* Lay down the dungeon features */
+	for (i = 0; i < vp_ptr->grid_num; i++)
+	{
+		g_ptr = &vp_ptr->grid[i];
 
-			/* Analyze the grid */
-			switch (*t)
-			{
-				/* Granite wall (outer) */
-				case '%':
-				{
-					cave_set_feat(y, x, FEAT_WALL_OUTER);
-					break;
-				}
+		/* Extract the location */
+		y = y1 + g_ptr->y;
+		x = x1 + g_ptr->x;
 
-				/* Granite wall (inner) */
-				case '#':
-				{
-					cave_set_feat(y, x, FEAT_WALL_INNER);
-					break;
-				}
+		/* Lay down the feature */
+		cave_set_feat(y, x, g_ptr->feat);
 
-				/* Permanent wall (inner) */
-				case 'X':
-				{
-					cave_set_feat(y, x, FEAT_PERM_INNER);
-					break;
-				}
+		/* Part of a vault */
+		cave_info[y][x] |= (CAVE_ROOM | CAVE_ICKY);
+	}
 
-				/* Treasure/trap */
-				case '*':
-				{
-					if (rand_int(100) < 75)
-					{
-						place_object(y, x, FALSE, FALSE);
-					}
-					else
-					{
-						place_trap(y, x);
-					}
-					break;
-				}
+	/* Place traps and objects */
+	for (n = i + vp_ptr->trap_num; i < n; i++)
+	{
+		g_ptr = &vp_ptr->grid[i];
 
-				/* Secret doors */
-				case '+':
-				{
-					place_secret_door(y, x);
-					break;
-				}
+		/* Extract the location */
+		y = y1 + g_ptr->y;
+		x = x1 + g_ptr->x;
 
-				/* Trap */
-				case '^':
-				{
-					place_trap(y, x);
-					break;
-				}
-			}
+		/* Treasure/trap */
+		if ((g_ptr->what == VAULT_TREASURE) && (rand_int(100) < 75))
+		{
+			place_object(y, x, FALSE, FALSE);
 		}
-	}
 
+		/* Trap */
+		else
+		{
+			place_trap(y, x);
+		}
+	}
 
 	/* Place dungeon monsters and objects */
-	for (t = data, dy = 0; dy < ymax; dy++)
+	for (n = i + vp_ptr->life_num; i < n; i++)
 	{
-		for (dx = 0; dx < xmax; dx++, t++)
+		g_ptr = &vp_ptr->grid[i];
+
+		/* Extract the location */
+		y = y1 + g_ptr->y;
+		x = x1 + g_ptr->x;
+
+		/* Analyze the grid */
+		switch (g_ptr->what)
 		{
-			/* Extract the grid */
-			x = x0 - (xmax/2) + dx;
-			y = y0 - (ymax/2) + dy;
+			/* Monster */
+			case VAULT_MONSTER:
+			{
+				monster_level = p_ptr->depth + 5;
+				place_monster(y, x, TRUE, TRUE);
+				monster_level = p_ptr->depth;
+				break;
+			}
 
-			/* Hack -- skip "non-grids" */
-			if (*t == ' ') continue;
+			/* Meaner monster */
+			case VAULT_MEANER:
+			{
+				monster_level = p_ptr->depth + 11;
+				place_monster(y, x, TRUE, TRUE);
+				monster_level = p_ptr->depth;
+				break;
+			}
 
-			/* Analyze the symbol */
-			switch (*t)
+			/* Meaner monster, plus treasure */
+			case VAULT_GUARDED:
 			{
-				/* Monster */
-				case '&':
-				{
-					monster_level = p_ptr->depth + 5;
-					place_monster(y, x, TRUE, TRUE);
-					monster_level = p_ptr->depth;
-					break;
-				}
+				monster_level = p_ptr->depth + 9;
+				place_monster(y, x, TRUE, TRUE);
+				monster_level = p_ptr->depth;
+				object_level = p_ptr->depth + 7;
+				place_object(y, x, TRUE, FALSE);
+				object_level = p_ptr->depth;
+				break;
+			}
 
-				/* Meaner monster */
-				case '@':
-				{
-					monster_level = p_ptr->depth + 11;
-					place_monster(y, x, TRUE, TRUE);
-					monster_level = p_ptr->depth;
-					break;
-				}
+			/* Nasty monster and treasure */
+			case VAULT_NASTY:
+			{
+				monster_level = p_ptr->depth + 40;
+				place_monster(y, x, TRUE, TRUE);
+				monster_level = p_ptr->depth;
+				object_level = p_ptr->depth + 20;
+				place_object(y, x, TRUE, TRUE);
+				object_level = p_ptr->depth;
+				break;
+			}
 
-				/* Meaner monster, plus treasure */
-				case '9':
+			/* Monster and/or object */
+			case VAULT_MAYBE:
+			{
+				if (rand_int(100) < 50)
 				{
-					monster_level = p_ptr->depth + 9;
+					monster_level = p_ptr->depth + 3;
 					place_monster(y, x, TRUE, TRUE);
 					monster_level = p_ptr->depth;
-					object_level = p_ptr->depth + 7;
-					place_object(y, x, TRUE, FALSE);
-					object_level = p_ptr->depth;
-					break;
 				}
-
-				/* Nasty monster and treasure */
-				case '8':
+				if (rand_int(100) < 50)
 				{
-					monster_level = p_ptr->depth + 40;
-					place_monster(y, x, TRUE, TRUE);
-					monster_level = p_ptr->depth;
-					object_level = p_ptr->depth + 20;
-					place_object(y, x, TRUE, TRUE);
+					object_level = p_ptr->depth + 7;
+					place_object(y, x, FALSE, FALSE);
 					object_level = p_ptr->depth;
-					break;
-				}
-
-				/* Monster and/or object */
-				case ',':
-				{
-					if (rand_int(100) < 50)
-					{
-						monster_level = p_ptr->depth + 3;
-						place_monster(y, x, TRUE, TRUE);
-						monster_level = p_ptr->depth;
-					}
-					if (rand_int(100) < 50)
-					{
-						object_level = p_ptr->depth + 7;
-						place_object(y, x, FALSE, FALSE);
-						object_level = p_ptr->depth;
-					}
-					break;
 				}
+				break;
 			}
 		}
 	}
+
+	/* Count the vault */
+	if (gen_stats) gen_stats->vaults++;
+
+	gen_phase_end(GEN_PHASE_VAULTS, start);
 }
 
 
@@ -2326,7 +2326,7 @@ static void build_type7(int y0, int x0)
 	}
 
 	/* Hack -- Build the vault */
-	build_vault(y0, x0, v_ptr->hgt, v_ptr->wid, v_text + v_ptr->text);
+	build_vault(y0, x0, v_ptr);
 }
 
 
@@ -2362,7 +2362,7 @@ static void build_type8(int y0, int x0)
 	}
 
 	/* Hack -- Build the vault */
-	build_vault(y0, x0, v_ptr->hgt, v_ptr->wid, v_text + v_ptr->text);
+	build_vault(y0, x0, v_ptr);
 }
 
 
@@ -2815,6 +2815,8 @@ static void cave_gen(void)
 
 	dun_data dun_body;
 
+	double start;
+
 
 	/* Global data */
 	dun = &dun_body;
@@ -2859,6 +2861,8 @@ static void cave_gen(void)
 	/* No rooms yet */
 	dun->cent_n = 0;
 
+	start = gen_phase_start();
+
 	/* Build some rooms */
 	for (i = 0; i < DUN_ROOMS; i++)
 	{
@@ -2922,6 +2926,11 @@ static void cave_gen(void)
 		if (room_build(by, bx, 1)) continue;
 	}
 
+	gen_phase_end(GEN_PHASE_ROOMS, start);
+
+	/* Count the rooms */
+	if (gen_stats) gen_stats->rooms = dun->cent_n;
+
 
 	/* Special boundary walls -- Top */
 	for (x = 0; x < DUNGEON_WID; x++)
@@ -2973,6 +2982,8 @@ static void cave_gen(void)
 		dun->cent[pick2].x = x1;
 	}
 
+	start = gen_phase_start();
+
 	/* Start with no tunnel doors */
 	dun->door_n = 0;
 
@@ -3005,6 +3016,10 @@ static void cave_gen(void)
 		try_door(y + 1, x);
 	}
 
+	gen_phase_end(GEN_PHASE_TUNNELS, start);
+
+
+	start = gen_phase_start();
 
 	/* Hack -- Add some magma streamers */
 	for (i = 0; i < DUN_STR_MAG; i++)
@@ -3018,6 +3033,8 @@ static void cave_gen(void)
 		build_streamer(FEAT_QUARTZ, DUN_STR_QC);
 	}
 
+	gen_phase_end(GEN_PHASE_STREAMERS, start);
+
 
 	/* Destroy the level if necessary */
 	if (destroyed) destroy_level();
@@ -3044,6 +3061,8 @@ static void cave_gen(void)
 	/* Determine the character location */
 	new_player_spot();
 
+	start = gen_phase_start();
+
 	/* Pick a base number of monsters */
 	i = MIN_M_ALLOC_LEVEL + randint(8);
 
@@ -3083,6 +3102,8 @@ static void cave_gen(void)
 		}
 	}
 
+	gen_phase_end(GEN_PHASE_MONSTERS, start);
+
 
 	/* Put some objects in rooms */
 	alloc_object(ALLOC_SET_ROOM, ALLOC_TYP_OBJECT, Rand_normal(DUN_AMT_ROOM, 3));
@@ -3352,6 +3373,37 @@ static void town_gen(void)
 }
 
 
+/*
+ * Extract the feeling of the current level from its "rating"
+ *
+ * This is done on arrival, for a spare level made ahead of time (see
+ * "level_cache_spare()") as well as a new one, since it takes time for
+ * feelings to recharge.
+ */
+static void level_feeling(void)
+{
+	/* Extract the feeling */
+	if (rating > 100) feeling = 2;
+	else if (rating > 80) feeling = 3;
+	else if (rating > 60) feeling = 4;
+	else if (rating > 40) feeling = 5;
+	else if (rating > 30) feeling = 6;
+	else if (rating > 20) feeling = 7;
+	else if (rating > 10) feeling = 8;
+	else if (rating > 0) feeling = 9;
+	else feeling = 10;
+
+	/* Hack -- Have a special feeling sometimes */
+	if (good_item_flag && !adult_preserve) feeling = 1;
+
+	/* It takes 1000 game turns for "feelings" to recharge */
+	if ((turn - old_turn) < 1000) feeling = 0;
+
+	/* Hack -- no feeling in the town */
+	if (!p_ptr->depth) feeling = 0;
+}
+
+
 /*
  * Generate a random dungeon level
  *
@@ -3363,13 +3415,57 @@ static void town_gen(void)
  */
 void generate_cave(void)
 {
-	int y, x, num;
+	int y, x, num, old_stream;
+
+	bool spare;
+
+	double start;
 
 
 	/* The dungeon is not ready */
 	character_dungeon = FALSE;
 
 
+	/* Levels are made from a stream of their own */
+	old_stream = Rand_stream_set(RAND_STREAM_GEN);
+
+
+	/* Revisit a remembered level, or use one made ahead of time */
+	if (p_ptr->depth)
+	{
+		/* Mega-Hack -- no player yet */
+		p_ptr->px = p_ptr->py = 0;
+
+		/* Hack -- illegal panel */
+		p_ptr->wy = DUNGEON_HGT;
+		p_ptr->wx = DUNGEON_WID;
+
+		if (level_cache_load(p_ptr->depth, &spare))
+		{
+			/* Reset the monster and object generation levels */
+			monster_level = p_ptr->depth;
+			object_level = p_ptr->depth;
+
+			/* Place the player */
+			new_player_spot();
+
+			/* A level made ahead of time is only felt now */
+			if (spare) level_feeling();
+
+			/* The dungeon is ready */
+			character_dungeon = TRUE;
+
+			/* Remember when this level was entered */
+			old_turn = turn;
+
+			/* Back to the old stream */
+			(void)Rand_stream_set(old_stream);
+
+			return;
+		}
+	}
+
+
 	/* Generate */
 	for (num = 0; TRUE; num++)
 	{
@@ -3378,6 +3474,12 @@ void generate_cave(void)
 		cptr why = NULL;
 
 
+		/* Time this attempt, in case it is rejected */
+		start = gen_phase_start();
+
+		/* Only count the vaults of the level that is kept */
+		if (gen_stats) gen_stats->vaults = 0;
+
 		/* Reset */
 		o_max = 1;
 		m_max = 1;
@@ -3448,24 +3550,7 @@ void generate_cave(void)
 
 
 		/* Extract the feeling */
-		if (rating > 100) feeling = 2;
-		else if (rating > 80) feeling = 3;
-		else if (rating > 60) feeling = 4;
-		else if (rating > 40) feeling = 5;
-		else if (rating > 30) feeling = 6;
-		else if (rating > 20) feeling = 7;
-		else if (rating > 10) feeling = 8;
-		else if (rating > 0) feeling = 9;
-		else feeling = 10;
-
-		/* Hack -- Have a special feeling sometimes */
-		if (good_item_flag && !adult_preserve) feeling = 1;
-
-		/* It takes 1000 game turns for "feelings" to recharge */
-		if ((turn - old_turn) < 1000) feeling = 0;
-
-		/* Hack -- no feeling in the town */
-		if (!p_ptr->depth) feeling = 0;
+		level_feeling();
 
 
 		/* Prevent object over-flow */
@@ -3523,6 +3608,19 @@ void generate_cave(void)
 
 		/* Wipe the monsters */
 		wipe_m_list();
+
+		/* Count the rejected level */
+		if (gen_stats) gen_stats->retries++;
+
+		gen_phase_end(GEN_PHASE_RETRY, start);
+	}
+
+
+	/* Count what is on the level */
+	if (gen_stats)
+	{
+		gen_stats->objects = o_cnt;
+		gen_stats->monsters = m_cnt;
 	}
 
 
@@ -3531,6 +3629,9 @@ void generate_cave(void)
 
 	/* Remember when this level was "created" */
 	old_turn = turn;
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
 
 
@@ -191,10 +191,13 @@
 /*
  * OPTION: Define "L64" if a "long" is 64-bits.  See "h-types.h".
  * The only such platform that angband is ported to is currently
- * DEC Alpha AXP running OSF/1 (OpenVMS uses 32-bit longs).
+ * DEC Alpha AXP running OSF/1 (OpenVMS uses 32-bit longs), and
+ * the 64-bit Unix systems, which say so with "__LP64__".
  */
-#if defined(__alpha) && defined(__osf__)
-# define L64
+#if (defined(__alpha) && defined(__osf__)) || defined(__LP64__)
+# ifndef L64
+#  define L64
+# endif
 #endif
 
 
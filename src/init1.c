@@ -608,6 +608,266 @@ static cptr c_info_flags[] =
 };
 
 
+/*** Flag name indexes ***/
+
+/*
+ * Maximum number of names in a single flag name index
+ */
+#define FLAG_INDEX_MAX	128
+
+
+/*
+ * A single name in a flag name index
+ */
+typedef struct flag_name flag_name;
+
+struct flag_name
+{
+	cptr name;		/* Name of the flag */
+
+	byte set;		/* Name table holding it (flags1, flags2, ...) */
+	byte bit;		/* Position within that name table */
+};
+
+
+/*
+ * A sorted index over one or more of the name tables above
+ *
+ * The "grab_one_*()" helpers used to try every name of every table
+ * with "streq()", which is hundreds of string compares per flag line.
+ * Instead, each index is sorted once, on first use, and then searched
+ * with a binary search.  Names occurring in several tables resolve to
+ * the earliest table, exactly as the old linear scan did.
+ */
+typedef struct flag_index flag_index;
+
+struct flag_index
+{
+	cptr *tables[4];	/* Name tables, in order of precedence */
+	int size;		/* Maximum number of names per table */
+
+	int num;		/* Number of indexed names (zero until built) */
+	flag_name names[FLAG_INDEX_MAX];
+};
+
+
+/*
+ * Object, artifact, ego-item and player race flags
+ */
+static flag_index kind_flag_index =
+{
+	{ k_info_flags1, k_info_flags2, k_info_flags3, NULL },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Monster race flags (basic)
+ */
+static flag_index basic_flag_index =
+{
+	{ r_info_flags1, r_info_flags2, r_info_flags3, r_info_flags7 },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Monster race flags (spells)
+ */
+static flag_index spell_flag_index =
+{
+	{ r_info_flags4, r_info_flags5, r_info_flags6, NULL },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Player class flags
+ */
+static flag_index class_flag_index =
+{
+	{ c_info_flags, NULL, NULL, NULL },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Monster blow methods
+ */
+static flag_index blow_method_index =
+{
+	{ r_info_blow_method, NULL, NULL, NULL },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Monster blow effects
+ */
+static flag_index blow_effect_index =
+{
+	{ r_info_blow_effect, NULL, NULL, NULL },
+	32, 0, { { NULL, 0, 0 } }
+};
+
+/*
+ * Artifact activations
+ */
+static flag_index activation_index =
+{
+	{ a_info_act, NULL, NULL, NULL },
+	ACT_MAX, 0, { { NULL, 0, 0 } }
+};
+
+
+/*
+ * Build a flag name index from its name tables
+ *
+ * Tables may be shorter than "size" if they are NULL terminated.
+ */
+static void flag_index_build(flag_index *idx)
+{
+	int set, bit, i;
+
+	flag_name tmp;
+
+	/* Collect the names, in order of precedence */
+	for (set = 0; (set < 4) && idx->tables[set]; set++)
+	{
+		cptr *names = idx->tables[set];
+
+		for (bit = 0; (bit < idx->size) && names[bit]; bit++)
+		{
+			/* Paranoia */
+			if (idx->num >= FLAG_INDEX_MAX) break;
+
+			/* Save the entry */
+			idx->names[idx->num].name = names[bit];
+			idx->names[idx->num].set = set;
+			idx->names[idx->num].bit = bit;
+
+			/* Insert it (stable, so precedence is kept for duplicates) */
+			tmp = idx->names[idx->num];
+
+			for (i = idx->num; i > 0; i--)
+			{
+				if (strcmp(idx->names[i - 1].name, tmp.name) <= 0) break;
+
+				idx->names[i] = idx->names[i - 1];
+			}
+
+			idx->names[i] = tmp;
+
+			idx->num++;
+		}
+	}
+}
+
+
+/*
+ * Find a name in a flag name index, or return NULL
+ */
+static const flag_name *flag_index_find(flag_index *idx, cptr what)
+{
+	int lo = 0, hi, mid;
+
+	/* Build the index on first use */
+	if (!idx->num) flag_index_build(idx);
+
+	hi = idx->num;
+
+	/* Find the first name which is not less than "what" */
+	while (lo < hi)
+	{
+		mid = (lo + hi) / 2;
+
+		if (strcmp(idx->names[mid].name, what) < 0) lo = mid + 1;
+		else hi = mid;
+	}
+
+	/* Found it */
+	if ((lo < idx->num) && streq(idx->names[lo].name, what))
+		return (&idx->names[lo]);
+
+	/* Oops */
+	return (NULL);
+}
+
+
+/*
+ * Find the name in a flag name index closest to a misspelled "what"
+ *
+ * Uses the edit distance, and ignores the "XXX" placeholder names.
+ * Returns NULL if nothing is reasonably close.
+ */
+static cptr flag_index_nearest(flag_index *idx, cptr what)
+{
+	int row[2][81];
+
+	int len = strlen(what);
+	int i, j, k;
+
+	int best_dist;
+	cptr best = NULL;
+
+	/* Build the index on first use */
+	if (!idx->num) flag_index_build(idx);
+
+	/* Don't bother with silly input */
+	if ((len < 1) || (len > 80)) return (NULL);
+
+	/* Allow roughly one mistake per three characters */
+	best_dist = MAX(2, len / 3) + 1;
+
+	for (k = 0; k < idx->num; k++)
+	{
+		cptr name = idx->names[k].name;
+		int n = strlen(name);
+		int *prev = row[0], *cur = row[1], *swap;
+
+		/* Skip placeholders and hopeless candidates */
+		if (prefix(name, "XXX")) continue;
+		if ((n > 80) || (ABS(n - len) >= best_dist)) continue;
+
+		/* Classic two-row edit distance */
+		for (j = 0; j <= n; j++) prev[j] = j;
+
+		for (i = 1; i <= len; i++)
+		{
+			cur[0] = i;
+
+			for (j = 1; j <= n; j++)
+			{
+				int cost = (what[i - 1] == name[j - 1]) ? 0 : 1;
+
+				cur[j] = MIN(prev[j] + 1, cur[j - 1] + 1);
+				cur[j] = MIN(cur[j], prev[j - 1] + cost);
+			}
+
+			swap = prev; prev = cur; cur = swap;
+		}
+
+		/* Remember the closest */
+		if (prev[n] < best_dist)
+		{
+			best_dist = prev[n];
+			best = name;
+		}
+	}
+
+	return (best);
+}
+
+
+/*
+ * Complain about an unknown name, suggesting the closest valid one
+ */
+static void flag_index_complain(flag_index *idx, cptr kind, cptr what)
+{
+	cptr near = flag_index_nearest(idx, what);
+
+	if (near)
+		msg_format("Unknown %s '%s' (did you mean '%s'?).", kind, what, near);
+	else
+		msg_format("Unknown %s '%s'.", kind, what);
+}
+
+
 /*** Initialize from ascii template files ***/
 
 
@@ -1140,22 +1400,20 @@ errr parse_f_info(char *buf, header *head)
 
 /*
  * Grab one flag from a textual string
+ *
+ * The "flags" array holds one flag set per name table of the index.
  */
-static errr grab_one_flag(u32b *flags, cptr names[], cptr what)
+static errr grab_one_flag(u32b *flags[], flag_index *idx, cptr what)
 {
-	int i;
+	const flag_name *f_ptr = flag_index_find(idx, what);
 
-	/* Check flags */
-	for (i = 0; i < 32; i++)
-	{
-		if (streq(what, names[i]))
-		{
-			*flags |= (1L << i);
-			return (0);
-		}
-	}
+	/* Unknown flag */
+	if (!f_ptr) return (-1);
 
-	return (-1);
+	/* Set the flag */
+	*flags[f_ptr->set] |= (1L << f_ptr->bit);
+
+	return (0);
 }
 
 
@@ -1164,17 +1422,17 @@ static errr grab_one_flag(u32b *flags, cptr names[], cptr what)
  */
 static errr grab_one_kind_flag(object_kind *k_ptr, cptr what)
 {
-	if (grab_one_flag(&k_ptr->flags1, k_info_flags1, what) == 0)
-		return (0);
+	u32b *flags[3];
 
-	if (grab_one_flag(&k_ptr->flags2, k_info_flags2, what) == 0)
-		return (0);
+	flags[0] = &k_ptr->flags1;
+	flags[1] = &k_ptr->flags2;
+	flags[2] = &k_ptr->flags3;
 
-	if (grab_one_flag(&k_ptr->flags3, k_info_flags3, what) == 0)
+	if (grab_one_flag(flags, &kind_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown object flag '%s'.", what);
+	flag_index_complain(&kind_flag_index, "object flag", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -1394,17 +1652,17 @@ errr parse_k_info(char *buf, header *head)
  */
 static errr grab_one_artifact_flag(artifact_type *a_ptr, cptr what)
 {
-	if (grab_one_flag(&a_ptr->flags1, k_info_flags1, what) == 0)
-		return (0);
+	u32b *flags[3];
 
-	if (grab_one_flag(&a_ptr->flags2, k_info_flags2, what) == 0)
-		return (0);
+	flags[0] = &a_ptr->flags1;
+	flags[1] = &a_ptr->flags2;
+	flags[2] = &a_ptr->flags3;
 
-	if (grab_one_flag(&a_ptr->flags3, k_info_flags3, what) == 0)
+	if (grab_one_flag(flags, &kind_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown artifact flag '%s'.", what);
+	flag_index_complain(&kind_flag_index, "artifact flag", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -1416,20 +1674,17 @@ static errr grab_one_artifact_flag(artifact_type *a_ptr, cptr what)
  */
 static errr grab_one_activation(artifact_type *a_ptr, cptr what)
 {
-	int i;
+	const flag_name *f_ptr = flag_index_find(&activation_index, what);
 
-	/* Scan activations */
-	for (i = 0; i < ACT_MAX; i++)
+	/* Found it */
+	if (f_ptr)
 	{
-		if (streq(what, a_info_act[i]))
-		{
-			a_ptr->activation = i;
-			return (0);
-		}
+		a_ptr->activation = f_ptr->bit;
+		return (0);
 	}
 
 	/* Oops */
-	msg_format("Unknown artifact activation '%s'.", what);
+	flag_index_complain(&activation_index, "artifact activation", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -1621,17 +1876,17 @@ errr parse_a_info(char *buf, header *head)
  */
 static bool grab_one_ego_item_flag(ego_item_type *e_ptr, cptr what)
 {
-	if (grab_one_flag(&e_ptr->flags1, k_info_flags1, what) == 0)
-		return (0);
+	u32b *flags[3];
 
-	if (grab_one_flag(&e_ptr->flags2, k_info_flags2, what) == 0)
-		return (0);
+	flags[0] = &e_ptr->flags1;
+	flags[1] = &e_ptr->flags2;
+	flags[2] = &e_ptr->flags3;
 
-	if (grab_one_flag(&e_ptr->flags3, k_info_flags3, what) == 0)
+	if (grab_one_flag(flags, &kind_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown ego-item flag '%s'.", what);
+	flag_index_complain(&kind_flag_index, "ego-item flag", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -1816,20 +2071,18 @@ errr parse_e_info(char *buf, header *head)
  */
 static errr grab_one_basic_flag(monster_race *r_ptr, cptr what)
 {
-	if (grab_one_flag(&r_ptr->flags1, r_info_flags1, what) == 0)
-		return (0);
+	u32b *flags[4];
 
-	if (grab_one_flag(&r_ptr->flags2, r_info_flags2, what) == 0)
-		return (0);
+	flags[0] = &r_ptr->flags1;
+	flags[1] = &r_ptr->flags2;
+	flags[2] = &r_ptr->flags3;
+	flags[3] = &r_ptr->flags7;
 
-	if (grab_one_flag(&r_ptr->flags3, r_info_flags3, what) == 0)
-		return (0);
-	
-	if (grab_one_flag(&r_ptr->flags7, r_info_flags7, what) == 0)
+	if (grab_one_flag(flags, &basic_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown monster flag '%s'.", what);
+	flag_index_complain(&basic_flag_index, "monster flag", what);
 
 	/* Failure */
 	return (PARSE_ERROR_GENERIC);
@@ -1841,17 +2094,17 @@ static errr grab_one_basic_flag(monster_race *r_ptr, cptr what)
  */
 static errr grab_one_spell_flag(monster_race *r_ptr, cptr what)
 {
-	if (grab_one_flag(&r_ptr->flags4, r_info_flags4, what) == 0)
-		return (0);
+	u32b *flags[3];
 
-	if (grab_one_flag(&r_ptr->flags5, r_info_flags5, what) == 0)
-		return (0);
+	flags[0] = &r_ptr->flags4;
+	flags[1] = &r_ptr->flags5;
+	flags[2] = &r_ptr->flags6;
 
-	if (grab_one_flag(&r_ptr->flags6, r_info_flags6, what) == 0)
+	if (grab_one_flag(flags, &spell_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown monster flag '%s'.", what);
+	flag_index_complain(&spell_flag_index, "monster flag", what);
 
 	/* Failure */
 	return (PARSE_ERROR_GENERIC);
@@ -1997,6 +2250,8 @@ errr parse_r_info(char *buf, header *head)
 	{
 		int n1, n2;
 
+		const flag_name *f_ptr;
+
 		/* There better be a current r_ptr */
 		if (!r_ptr) return (PARSE_ERROR_MISSING_RECORD_HEADER);
 
@@ -2013,13 +2268,16 @@ errr parse_r_info(char *buf, header *head)
 		if (*t == ':') *t++ = '\0';
 
 		/* Analyze the method */
-		for (n1 = 0; r_info_blow_method[n1]; n1++)
+		f_ptr = flag_index_find(&blow_method_index, s);
+
+		/* Invalid method */
+		if (!f_ptr)
 		{
-			if (streq(s, r_info_blow_method[n1])) break;
+			flag_index_complain(&blow_method_index, "monster blow method", s);
+			return (PARSE_ERROR_GENERIC);
 		}
 
-		/* Invalid method */
-		if (!r_info_blow_method[n1]) return (PARSE_ERROR_GENERIC);
+		n1 = f_ptr->bit;
 
 		/* Analyze the second field */
 		for (s = t; *t && (*t != ':'); t++) /* loop */;
@@ -2028,13 +2286,16 @@ errr parse_r_info(char *buf, header *head)
 		if (*t == ':') *t++ = '\0';
 
 		/* Analyze effect */
-		for (n2 = 0; r_info_blow_effect[n2]; n2++)
+		f_ptr = flag_index_find(&blow_effect_index, s);
+
+		/* Invalid effect */
+		if (!f_ptr)
 		{
-			if (streq(s, r_info_blow_effect[n2])) break;
+			flag_index_complain(&blow_effect_index, "monster blow effect", s);
+			return (PARSE_ERROR_GENERIC);
 		}
 
-		/* Invalid effect */
-		if (!r_info_blow_effect[n2]) return (PARSE_ERROR_GENERIC);
+		n2 = f_ptr->bit;
 
 		/* Analyze the third field */
 		for (s = t; *t && (*t != 'd'); t++) /* loop */;
@@ -2175,17 +2436,17 @@ errr parse_r_info(char *buf, header *head)
  */
 static errr grab_one_racial_flag(player_race *pr_ptr, cptr what)
 {
-	if (grab_one_flag(&pr_ptr->flags1, k_info_flags1, what) == 0)
-		return (0);
+	u32b *flags[3];
 
-	if (grab_one_flag(&pr_ptr->flags2, k_info_flags2, what) == 0)
-		return (0);
+	flags[0] = &pr_ptr->flags1;
+	flags[1] = &pr_ptr->flags2;
+	flags[2] = &pr_ptr->flags3;
 
-	if (grab_one_flag(&pr_ptr->flags3, k_info_flags3, what) == 0)
+	if (grab_one_flag(flags, &kind_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown player flag '%s'.", what);
+	flag_index_complain(&kind_flag_index, "player flag", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -2440,11 +2701,15 @@ errr parse_p_info(char *buf, header *head)
  */
 static errr grab_one_class_flag(player_class *pc_ptr, cptr what)
 {
-	if (grab_one_flag(&pc_ptr->flags, c_info_flags, what) == 0)
+	u32b *flags[1];
+
+	flags[0] = &pc_ptr->flags;
+
+	if (grab_one_flag(flags, &class_flag_index, what) == 0)
 		return (0);
 
 	/* Oops */
-	msg_format("Unknown player class flag '%s'.", what);
+	flag_index_complain(&class_flag_index, "player class flag", what);
 
 	/* Error */
 	return (PARSE_ERROR_GENERIC);
@@ -13,6 +13,7 @@
 
 #include "init.h"
 #include "logging.h"
+#include "profile.h"
 
 
 /*
@@ -287,16 +288,160 @@ header g_head;
 
 
 
+/*** Demand-loaded text arrays ***/
+
+
+/*
+ * A "*_text" array which is only loaded from its "raw" file on first use
+ *
+ * Most descriptions are only ever read by monster recall and the spoiler
+ * files, so there is no point in keeping them in memory all the time.
+ */
+typedef struct delayed_text delayed_text;
+
+struct delayed_text
+{
+	header *head;		/* Header of the "*_info" array */
+
+	cptr filename;		/* Base name of the "raw" file */
+
+	char **text;		/* Global pointer to the "*_text" array */
+
+	long pos;		/* Position of the "*_text" array in the "raw" file */
+};
+
+/*
+ * Maximum number of delayed "*_text" arrays
+ */
+#define MAX_DELAYED_TEXT	8
+
+static delayed_text delayed_texts[MAX_DELAYED_TEXT];
+static int delayed_text_num = 0;
+
+
+/*
+ * Find the delayed "*_text" array of a header, if any
+ */
+static delayed_text *find_delayed_text(const header *head)
+{
+	int i;
+
+	for (i = 0; i < delayed_text_num; i++)
+	{
+		if (delayed_texts[i].head == head) return (&delayed_texts[i]);
+	}
+
+	return (NULL);
+}
+
+
+/*
+ * Request that the "*_text" array of a header is loaded on demand
+ *
+ * Must be called before the "*_info" array is initialized.
+ */
+static void delay_info_text(header *head)
+{
+	/* Paranoia */
+	if (find_delayed_text(head)) return;
+	if (delayed_text_num >= MAX_DELAYED_TEXT) return;
+
+	/* Remember the header, the rest is filled in by "init_info()" */
+	WIPE(&delayed_texts[delayed_text_num], delayed_text);
+	delayed_texts[delayed_text_num++].head = head;
+}
+
+
+/*
+ * Load a delayed "*_text" array, if it was not loaded yet
+ *
+ * The "text" argument is the address of the global pointer to the array,
+ * such as "&r_text".  Arrays which are not delayed are always available.
+ *
+ * Returns 0 if the array is available.
+ */
+errr load_info_text(char **text)
+{
+	int i, fd;
+
+	header test;
+
+	delayed_text *dt = NULL;
+
+	char buf[1024];
+
+
+	/* Already available */
+	if (*text) return (0);
+
+	/* Find the array */
+	for (i = 0; i < delayed_text_num; i++)
+	{
+		if (delayed_texts[i].text == text) dt = &delayed_texts[i];
+	}
+
+	/* Unknown array */
+	if (!dt || !dt->filename) return (-1);
+
+	/* Build the filename */
+	path_build(buf, 1024, ANGBAND_DIR_DATA, format("%s.raw", dt->filename));
+
+	/* Open the "raw" file */
+	fd = fd_open(buf, O_RDONLY);
+
+	/* Oops */
+	if (fd < 0) return (-1);
+
+	/* Make sure the file was not rebuilt in the meantime */
+	if (fd_read(fd, (char*)(&test), sizeof(header)) ||
+	    (test.info_size != dt->head->info_size) ||
+	    (test.name_size != dt->head->name_size) ||
+	    (test.text_size != dt->head->text_size) ||
+	    fd_seek(fd, dt->pos))
+	{
+		fd_close(fd);
+		return (-1);
+	}
+
+	/* Allocate the "*_text" array */
+	C_MAKE(dt->head->text_ptr, dt->head->text_size, char);
+
+	/* Read the "*_text" array */
+	if (fd_read(fd, dt->head->text_ptr, dt->head->text_size))
+	{
+		/* Oops */
+		C_KILL(dt->head->text_ptr, dt->head->text_size, char);
+
+		fd_close(fd);
+		return (-1);
+	}
+
+	/* Close it */
+	fd_close(fd);
+
+	/* The array is now available */
+	(*text) = dt->head->text_ptr;
+
+	/* Success */
+	return (0);
+}
+
+
+
 /*** Initialize from binary image files ***/
 
 
 /*
  * Initialize a "*_info" array, by parsing a binary "image" file
+ *
+ * Delayed "*_text" arrays are skipped, see "load_info_text()".
  */
 static errr init_info_raw(int fd, header *head)
 {
 	header test;
 
+	delayed_text *dt = find_delayed_text(head);
+
 
 	/* Read and verify the header */
 	if (fd_read(fd, (char*)(&test), sizeof(header)) ||
@@ -333,7 +478,15 @@ static errr init_info_raw(int fd, header *head)
 		fd_read(fd, head->name_ptr, head->name_size);
 	}
 
-	if (head->text_size)
+	/* Forget the stale pointer read from the file */
+	head->text_ptr = NULL;
+
+	if (head->text_size && dt)
+	{
+		/* Remember where the "*_text" array is, and leave it there */
+		dt->pos = (long)(head->head_size + head->info_size + head->name_size);
+	}
+	else if (head->text_size)
 	{
 		/* Allocate the "*_text" array */
 		C_MAKE(head->text_ptr, head->text_size, char);
@@ -408,6 +561,8 @@ static errr init_info(cptr filename, header *head,
 
 	FILE *fp;
 
+	delayed_text *dt;
+
 	/* General buffer */
 	char buf[1024];
 
@@ -511,7 +666,7 @@ static errr init_info(cptr filename, header *head,
 				char why[1024];
 
 				/* Message */
-				sprintf(why, "Cannot create the '%s' file!", buf);
+				strnfmt(why, sizeof(why), "Cannot create the '%s' file!", buf);
 
 				/* Crash and burn */
 				quit(why);
@@ -593,6 +748,15 @@ static errr init_info(cptr filename, header *head,
 	if (name) (*name) = head->name_ptr;
 	if (text) (*text) = head->text_ptr;
 
+	/* Remember how to load a delayed "*_text" array */
+	dt = find_delayed_text(head);
+
+	if (dt && text)
+	{
+		dt->filename = filename;
+		dt->text = text;
+	}
+
 	/* Success */
 	return (0);
 }
@@ -666,6 +830,13 @@ static errr init_k_info(void)
 	/* Init the header */
 	init_header(&k_head, z_info->k_max, sizeof(object_kind));
 
+#ifdef DELAY_LOAD_K_TEXT
+
+	/* Load the descriptions on demand */
+	delay_info_text(&k_head);
+
+#endif /* DELAY_LOAD_K_TEXT */
+
 #ifdef ALLOW_TEMPLATES
 
 	/* Save a pointer to the parsing function */
@@ -687,6 +858,13 @@ static errr init_a_info(void)
 	/* Init the header */
 	init_header(&a_head, z_info->a_max, sizeof(artifact_type));
 
+#ifdef DELAY_LOAD_A_TEXT
+
+	/* Load the descriptions on demand */
+	delay_info_text(&a_head);
+
+#endif /* DELAY_LOAD_A_TEXT */
+
 #ifdef ALLOW_TEMPLATES
 
 	/* Save a pointer to the parsing function */
@@ -708,6 +886,13 @@ static errr init_e_info(void)
 	/* Init the header */
 	init_header(&e_head, z_info->e_max, sizeof(ego_item_type));
 
+#ifdef DELAY_LOAD_E_TEXT
+
+	/* Load the descriptions on demand */
+	delay_info_text(&e_head);
+
+#endif /* DELAY_LOAD_E_TEXT */
+
 #ifdef ALLOW_TEMPLATES
 
 	/* Save a pointer to the parsing function */
@@ -729,6 +914,13 @@ static errr init_r_info(void)
 	/* Init the header */
 	init_header(&r_head, z_info->r_max, sizeof(monster_race));
 
+#ifdef DELAY_LOAD_R_TEXT
+
+	/* Load the descriptions on demand */
+	delay_info_text(&r_head);
+
+#endif /* DELAY_LOAD_R_TEXT */
+
 #ifdef ALLOW_TEMPLATES
 
 	/* Save a pointer to the parsing function */
@@ -762,6 +954,140 @@ static errr init_v_info(void)
 }
 
 
+/*
+ * Compile one grid of a vault layout (see "vault.txt")
+ *
+ * The feature goes in "g_ptr", and anything else to be placed there in
+ * "g_ptr->what", which is zero if there is nothing.
+ */
+static void init_v_grid(vault_grid *g_ptr, int y, int x, char c)
+{
+	/* Location */
+	g_ptr->y = y;
+	g_ptr->x = x;
+
+	/* Floor with nothing on it */
+	g_ptr->feat = FEAT_FLOOR;
+	g_ptr->what = 0;
+
+	/* Analyze the symbol */
+	switch (c)
+	{
+		/* Granite wall (outer) */
+		case '%': g_ptr->feat = FEAT_WALL_OUTER; break;
+
+		/* Granite wall (inner) */
+		case '#': g_ptr->feat = FEAT_WALL_INNER; break;
+
+		/* Permanent wall (inner) */
+		case 'X': g_ptr->feat = FEAT_PERM_INNER; break;
+
+		/* Secret door */
+		case '+': g_ptr->feat = FEAT_SECRET; break;
+
+		/* Treasure/trap */
+		case '*': g_ptr->what = VAULT_TREASURE; break;
+
+		/* Trap */
+		case '^': g_ptr->what = VAULT_TRAP; break;
+
+		/* Monster */
+		case '&': g_ptr->what = VAULT_MONSTER; break;
+
+		/* Meaner monster */
+		case '@': g_ptr->what = VAULT_MEANER; break;
+
+		/* Meaner monster, plus treasure */
+		case '9': g_ptr->what = VAULT_GUARDED; break;
+
+		/* Nasty monster and treasure */
+		case '8': g_ptr->what = VAULT_NASTY; break;
+
+		/* Monster and/or object */
+		case ',': g_ptr->what = VAULT_MAYBE; break;
+	}
+}
+
+
+/*
+ * Compile the vault layouts into lists of grids
+ *
+ * This is done once, so that "build_vault()" can lay down the features
+ * and place the traps, monsters and objects of a vault straight from the
+ * lists, instead of reading its layout from "v_text" every time.
+ */
+static errr init_v_plan(void)
+{
+	int i, y, x, n, t, l;
+
+	vault_grid grid;
+
+	cptr s;
+
+
+	/* Allocate the plans */
+	C_MAKE(v_plan, z_info->v_max, vault_plan);
+
+	/* Compile each vault */
+	for (i = 0; i < z_info->v_max; i++)
+	{
+		vault_type *v_ptr = &v_info[i];
+		vault_plan *vp_ptr = &v_plan[i];
+
+		/* Count the grids */
+		for (s = v_text + v_ptr->text, y = 0; y < v_ptr->hgt; y++)
+		{
+			for (x = 0; x < v_ptr->wid; x++, s++)
+			{
+				/* Paranoia -- the layout is too short */
+				if (!*s) return (-1);
+
+				/* Skip "non-grids" */
+				if (*s == ' ') continue;
+
+				init_v_grid(&grid, y, x, *s);
+
+				vp_ptr->grid_num++;
+
+				if ((grid.what == VAULT_TREASURE) ||
+				    (grid.what == VAULT_TRAP)) vp_ptr->trap_num++;
+				else if (grid.what) vp_ptr->life_num++;
+			}
+		}
+
+		/* Allocate the lists */
+		C_MAKE(vp_ptr->grid, vp_ptr->grid_num + vp_ptr->trap_num +
+		       vp_ptr->life_num, vault_grid);
+
+		/* Where each list starts */
+		n = 0;
+		t = vp_ptr->grid_num;
+		l = vp_ptr->grid_num + vp_ptr->trap_num;
+
+		/* Fill them in */
+		for (s = v_text + v_ptr->text, y = 0; y < v_ptr->hgt; y++)
+		{
+			for (x = 0; x < v_ptr->wid; x++, s++)
+			{
+				/* Skip "non-grids" */
+				if (*s == ' ') continue;
+
+				init_v_grid(&grid, y, x, *s);
+
+				vp_ptr->grid[n++] = grid;
+
+				if ((grid.what == VAULT_TREASURE) ||
+				    (grid.what == VAULT_TRAP)) vp_ptr->grid[t++] = grid;
+				else if (grid.what) vp_ptr->grid[l++] = grid;
+			}
+		}
+	}
+
+	/* Success */
+	return (0);
+}
+
+
 /*
  * Initialize the "p_info" array
  */
@@ -1176,7 +1502,9 @@ static errr init_other(void)
 	/*** Prepare "vinfo" array ***/
 
 	/* Used by "update_view()" */
+	profile_begin("vinfo_init");
 	(void)vinfo_init();
+	profile_end();
 
 
 	/*** Prepare entity arrays ***/
@@ -1661,8 +1989,12 @@ void init_angband(void)
 
 	LOG_D("init_angband() started");
 
+	profile_begin("init_angband");
+
 	/*** Verify the "news" file ***/
 
+	profile_begin("news");
+
 	LOG_D("Building news.txt path");
 	/* Build the filename */
 	path_build(buf, 1024, ANGBAND_DIR_FILE, "news.txt");
@@ -1679,7 +2011,7 @@ void init_angband(void)
 		char why[1024];
 
 		/* Message */
-		sprintf(why, "Cannot access the '%s' file!", buf);
+		strnfmt(why, sizeof(why), "Cannot access the '%s' file!", buf);
 
 		/* Crash and burn */
 		init_angband_aux(why);
@@ -1756,9 +2088,13 @@ void init_angband(void)
 		LOG_D("Term_fresh() returned successfully");
 	}
 
+	profile_end();
+
 
 	/*** Verify (or create) the "high score" file ***/
 
+	profile_begin("scores");
+
 	/* Build the filename */
 	path_build(buf, 1024, ANGBAND_DIR_APEX, "scores.raw");
 
@@ -1786,7 +2122,7 @@ void init_angband(void)
 			char why[1024];
 
 			/* Message */
-			sprintf(why, "Cannot create the '%s' file!", buf);
+			strnfmt(why, sizeof(why), "Cannot create the '%s' file!", buf);
 
 			/* Crash and burn */
 			init_angband_aux(why);
@@ -1796,64 +2132,99 @@ void init_angband(void)
 	/* Close it */
 	fd_close(fd);
 
+	profile_end();
+
 
 	/*** Initialize some arrays ***/
 
 	/* Initialize size info */
 	note("[Initializing array sizes...]");
+	profile_begin("init_z_info");
 	if (init_z_info()) quit("Cannot initialize sizes");
+	profile_end();
 
 	/* Initialize feature info */
 	note("[Initializing arrays... (features)]");
+	profile_begin("init_f_info");
 	if (init_f_info()) quit("Cannot initialize features");
+	profile_end();
 
 	/* Initialize object info */
 	note("[Initializing arrays... (objects)]");
+	profile_begin("init_k_info");
 	if (init_k_info()) quit("Cannot initialize objects");
+	profile_end();
 
 	/* Initialize artifact info */
 	note("[Initializing arrays... (artifacts)]");
+	profile_begin("init_a_info");
 	if (init_a_info()) quit("Cannot initialize artifacts");
+	profile_end();
 
 	/* Initialize ego-item info */
 	note("[Initializing arrays... (ego-items)]");
+	profile_begin("init_e_info");
 	if (init_e_info()) quit("Cannot initialize ego-items");
+	profile_end();
 
 	/* Initialize monster info */
 	note("[Initializing arrays... (monsters)]");
+	profile_begin("init_r_info");
 	if (init_r_info()) quit("Cannot initialize monsters");
+	profile_end();
 
 	/* Initialize feature info */
 	note("[Initializing arrays... (vaults)]");
+	profile_begin("init_v_info");
 	if (init_v_info()) quit("Cannot initialize vaults");
+	profile_end();
+
+	/* Compile the vaults */
+	profile_begin("init_v_plan");
+	if (init_v_plan()) quit("Cannot compile vaults");
+	profile_end();
 
 	/* Initialize history info */
 	note("[Initializing arrays... (histories)]");
+	profile_begin("init_h_info");
 	if (init_h_info()) quit("Cannot initialize histories");
+	profile_end();
 
 	/* Initialize race info */
 	note("[Initializing arrays... (races)]");
+	profile_begin("init_p_info");
 	if (init_p_info()) quit("Cannot initialize races");
+	profile_end();
 
 	/* Initialize class info */
 	note("[Initializing arrays... (classes)]");
+	profile_begin("init_c_info");
 	if (init_c_info()) quit("Cannot initialize classes");
+	profile_end();
 
 	/* Initialize owner info */
 	note("[Initializing arrays... (owners)]");
+	profile_begin("init_b_info");
 	if (init_b_info()) quit("Cannot initialize owners");
+	profile_end();
 
 	/* Initialize price info */
 	note("[Initializing arrays... (prices)]");
+	profile_begin("init_g_info");
 	if (init_g_info()) quit("Cannot initialize prices");
+	profile_end();
 
 	/* Initialize some other arrays */
 	note("[Initializing arrays... (other)]");
+	profile_begin("init_other");
 	if (init_other()) quit("Cannot initialize other stuff");
+	profile_end();
 
 	/* Initialize some other arrays */
 	note("[Initializing arrays... (alloc)]");
+	profile_begin("init_alloc");
 	if (init_alloc()) quit("Cannot initialize alloc stuff");
+	profile_end();
 
 
 	/*** Load default user pref files ***/
@@ -1862,10 +2233,14 @@ void init_angband(void)
 	note("[Loading basic user pref file...]");
 
 	/* Process that file */
+	profile_begin("pref.prf");
 	(void)process_pref_file("pref.prf");
+	profile_end();
 
 	/* Done */
 	note("[Initialization complete]");
+
+	profile_end();
 }
 
 
@@ -1956,6 +2331,22 @@ void cleanup_angband(void)
 	/* Free the "quarks" */
 	quarks_free();
 
+	/* Free the compiled vaults */
+	if (v_plan)
+	{
+		for (i = 0; i < z_info->v_max; i++)
+		{
+			vault_plan *vp_ptr = &v_plan[i];
+
+			if (!vp_ptr->grid) continue;
+
+			C_FREE(vp_ptr->grid, vp_ptr->grid_num + vp_ptr->trap_num +
+			       vp_ptr->life_num, vault_grid);
+		}
+
+		C_FREE(v_plan, z_info->v_max, vault_plan);
+	}
+
 	/* Free the info, name, and text arrays */
 	free_info(&g_head);
 	free_info(&b_head);
@@ -0,0 +1,479 @@
+/* File: level_cache.c */
+
+/*
+ * Purpose: remember recently visited dungeon levels
+ *
+ * When the "persistent_levels" option is set, a level is packed into
+ * memory as the player leaves it, and unpacked again if the player comes
+ * back to the same depth, instead of generating a new level.  Only the
+ * most recently visited LEVEL_CACHE_MAX levels are kept.  The cache does
+ * not survive saving and quitting; only the current level is saved.
+ *
+ * The cache also holds "spare" levels, made ahead of time for the depths
+ * the player may go to next (see "level_cache_spare()"), whether or not
+ * the option is set.
+ */
+
+#include "angband.h"
+
+#include "compress.h"
+#include "replay.h"
+
+
+/*
+ * A remembered level
+ */
+typedef struct level_cache_type level_cache_type;
+
+struct level_cache_type
+{
+	s16b depth;			/* Depth of the level (0 if unused) */
+
+	s16b o_max;			/* Number of entries in o_list[] */
+	s16b m_max;			/* Number of entries in m_list[] */
+
+	byte feeling;		/* Level feeling */
+
+	s16b rating;		/* Level rating */
+	bool good_item;		/* Level has a special feeling */
+
+	bool spare;			/* Made ahead of time, never visited */
+
+	u32b used;			/* When the level was last stored */
+
+	u32b raw_len;		/* Unpacked size */
+	u32b len;			/* Packed size */
+	byte *buf;			/* Packed level */
+};
+
+
+/*
+ * The remembered levels
+ */
+static level_cache_type level_cache[LEVEL_CACHE_MAX];
+
+/*
+ * Counter used to find the least recently stored level
+ */
+static u32b level_cache_stamp = 0L;
+
+
+/*
+ * Size of the cave arrays of a level, unpacked
+ */
+#define CAVE_GRIDS	(DUNGEON_HGT * DUNGEON_WID)
+#define CAVE_BYTES	(CAVE_GRIDS * (2 + 2 * sizeof(s16b)))
+
+
+/*
+ * Forget a remembered level
+ */
+static void level_cache_free(level_cache_type *l_ptr)
+{
+	if (l_ptr->buf) C_KILL(l_ptr->buf, l_ptr->len, byte);
+
+	(void)WIPE(l_ptr, level_cache_type);
+}
+
+
+/*
+ * Forget all remembered levels
+ */
+void level_cache_wipe(void)
+{
+	int i;
+
+	for (i = 0; i < LEVEL_CACHE_MAX; i++) level_cache_free(&level_cache[i]);
+}
+
+
+/*
+ * Store the current level as the level at "depth"
+ *
+ * The level is stored as the raw cave arrays, followed by o_list[] and
+ * m_list[] as they are, compressed (see "compress.c").  The least
+ * recently stored level is dropped if the cache is full, except that a
+ * spare level only ever replaces another spare level.
+ */
+static void level_cache_put(int depth, bool spare)
+{
+	level_cache_type *l_ptr = NULL;
+	byte *raw, *p;
+	byte *packed;
+	u32b raw_len, bound, len;
+	int i, y;
+
+	/* Paranoia -- the town is never remembered */
+	if (depth <= 0) return;
+
+	/* Replace an older copy of this depth, or use a free entry */
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		if (level_cache[i].depth == depth)
+		{
+			l_ptr = &level_cache[i];
+			break;
+		}
+
+		if (!l_ptr && !level_cache[i].depth) l_ptr = &level_cache[i];
+	}
+
+	/* Drop the least recently stored level (only a spare one, for a spare) */
+	if (!l_ptr)
+	{
+		for (i = 0; i < LEVEL_CACHE_MAX; i++)
+		{
+			if (spare && !level_cache[i].spare) continue;
+
+			if (!l_ptr || (level_cache[i].used < l_ptr->used))
+			{
+				l_ptr = &level_cache[i];
+			}
+		}
+	}
+
+	/* No room for a spare level */
+	if (!l_ptr) return;
+
+	/* Compact the objects and monsters */
+	compact_objects(0);
+	compact_monsters(0);
+
+	/* The player is not part of the level */
+	cave_m_idx[p_ptr->py][p_ptr->px] = 0;
+
+	/* Pack the level */
+	raw_len = CAVE_BYTES + o_max * sizeof(object_type) +
+	          m_max * sizeof(monster_type);
+	C_MAKE(raw, raw_len, byte);
+
+	p = raw;
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		/* Drop the view flags */
+		for (i = 0; i < DUNGEON_WID; i++)
+		{
+			*p++ = (byte)(cave_info[y][i] & ~(CAVE_SEEN | CAVE_VIEW | CAVE_TEMP));
+		}
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(p, cave_feat[y], DUNGEON_WID, byte);
+		p += DUNGEON_WID;
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(p, cave_o_idx[y], DUNGEON_WID * sizeof(s16b), byte);
+		p += DUNGEON_WID * sizeof(s16b);
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(p, cave_m_idx[y], DUNGEON_WID * sizeof(s16b), byte);
+		p += DUNGEON_WID * sizeof(s16b);
+	}
+	(void)C_COPY(p, o_list, o_max * sizeof(object_type), byte);
+	p += o_max * sizeof(object_type);
+	(void)C_COPY(p, m_list, m_max * sizeof(monster_type), byte);
+
+	/* Compress it */
+	bound = compress_bound(raw_len);
+	C_MAKE(packed, bound, byte);
+	len = compress_block(raw, raw_len, packed, bound);
+	C_KILL(raw, raw_len, byte);
+
+	/* Failure -- the level is simply not remembered */
+	if (!len)
+	{
+		C_KILL(packed, bound, byte);
+		return;
+	}
+
+	level_cache_free(l_ptr);
+
+	/* Keep only the packed bytes */
+	C_MAKE(l_ptr->buf, len, byte);
+	(void)C_COPY(l_ptr->buf, packed, len, byte);
+	C_KILL(packed, bound, byte);
+
+	l_ptr->depth = depth;
+	l_ptr->o_max = o_max;
+	l_ptr->m_max = m_max;
+	l_ptr->feeling = feeling;
+	l_ptr->rating = rating;
+	l_ptr->good_item = good_item_flag;
+	l_ptr->spare = spare;
+	l_ptr->used = ++level_cache_stamp;
+	l_ptr->raw_len = raw_len;
+	l_ptr->len = len;
+}
+
+
+/*
+ * Remember the current level, which is about to be wiped
+ */
+void level_cache_store(int depth)
+{
+	level_cache_put(depth, FALSE);
+}
+
+
+/*
+ * Bring back a remembered level, if there is one for the given depth
+ *
+ * The level is taken out of the cache (it is stored again when the player
+ * leaves it).  The caller must still place the player, and work out the
+ * feeling of a spare level, which is not felt until it is used ("*spare"
+ * is set for one).
+ *
+ * Monsters and artifacts that have turned up elsewhere since the level
+ * was stored (or been killed, for uniques) are removed from it.
+ */
+bool level_cache_load(int depth, bool *spare)
+{
+	level_cache_type *l_ptr = NULL;
+	byte *raw, *p;
+	int i, y;
+
+	/* Find the level */
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		if (depth && (level_cache[i].depth == depth)) l_ptr = &level_cache[i];
+	}
+
+	/* Not remembered */
+	if (!l_ptr) return (FALSE);
+
+	/* Unpack it */
+	C_MAKE(raw, l_ptr->raw_len, byte);
+
+	if (decompress_block(l_ptr->buf, l_ptr->len, raw, l_ptr->raw_len) !=
+	    (long)l_ptr->raw_len)
+	{
+		/* Paranoia -- generate a new level instead */
+		C_KILL(raw, l_ptr->raw_len, byte);
+		level_cache_free(l_ptr);
+		return (FALSE);
+	}
+
+	p = raw;
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(cave_info[y], p, DUNGEON_WID, byte);
+		p += DUNGEON_WID;
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(cave_feat[y], p, DUNGEON_WID, byte);
+		p += DUNGEON_WID;
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(cave_o_idx[y], p, DUNGEON_WID * sizeof(s16b), byte);
+		p += DUNGEON_WID * sizeof(s16b);
+	}
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_COPY(cave_m_idx[y], p, DUNGEON_WID * sizeof(s16b), byte);
+		p += DUNGEON_WID * sizeof(s16b);
+	}
+
+#ifdef MONSTER_FLOW
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		(void)C_WIPE(cave_cost[y], DUNGEON_WID, byte);
+		(void)C_WIPE(cave_when[y], DUNGEON_WID, byte);
+	}
+#endif /* MONSTER_FLOW */
+
+	o_max = l_ptr->o_max;
+	(void)C_COPY(o_list, p, o_max * sizeof(object_type), byte);
+	p += o_max * sizeof(object_type);
+
+	m_max = l_ptr->m_max;
+	(void)C_COPY(m_list, p, m_max * sizeof(monster_type), byte);
+
+	feeling = l_ptr->feeling;
+	rating = l_ptr->rating;
+	good_item_flag = l_ptr->good_item;
+	*spare = l_ptr->spare;
+
+	C_KILL(raw, l_ptr->raw_len, byte);
+	level_cache_free(l_ptr);
+
+
+	/* Count the monsters, as "monster_place()" would */
+	m_cnt = 0;
+	for (i = 1; i < m_max; i++)
+	{
+		monster_type *m_ptr = &m_list[i];
+		monster_race *r_ptr = &r_info[m_ptr->r_idx];
+
+		/* Skip dead monsters */
+		if (!m_ptr->r_idx) continue;
+
+		m_cnt++;
+		r_ptr->cur_num++;
+		if (r_ptr->flags2 & (RF2_MULTIPLY)) num_repro++;
+
+		/* Player ghosts and uniques found elsewhere (or killed) leave */
+		if ((m_ptr->r_idx >= z_info->r_max - 1) ||
+		    (r_ptr->cur_num > r_ptr->max_num))
+		{
+			delete_monster_idx(i);
+		}
+	}
+
+	/* Count the objects */
+	o_cnt = 0;
+	for (i = 1; i < o_max; i++)
+	{
+		object_type *o_ptr = &o_list[i];
+
+		/* Skip dead objects */
+		if (!o_ptr->k_idx) continue;
+
+		o_cnt++;
+
+		/* Artifacts */
+		if (artifact_p(o_ptr))
+		{
+			artifact_type *a_ptr = &a_info[o_ptr->name1];
+
+			/* Reclaim an artifact that was preserved on leaving */
+			if (!a_ptr->cur_num)
+			{
+				a_ptr->cur_num = 1;
+			}
+
+			/* It was preserved (or never seen), and has been found since */
+			else if ((adult_preserve || *spare) && !object_known_p(o_ptr))
+			{
+				delete_object_idx(i);
+			}
+		}
+	}
+
+	/* Success */
+	return (TRUE);
+}
+
+
+/*
+ * Make one of the levels the player may go to next ahead of time
+ *
+ * This is called while waiting for a command.  The levels one up, one
+ * down, and at the recall depth are made in turn, each as if the player
+ * had just arrived there, and stored as spare levels that "generate_cave()"
+ * picks up instead of making a new one.  Everything else is put back from
+ * a snapshot afterwards, except that the level generation stream of the
+ * RNG carries on from where it got to, so that the next level made is not
+ * a copy of this one.  Messages are dropped while the level is made (see
+ * "msg_silent"), since they would give away what is on it, or stop for
+ * a "-more-" prompt.
+ *
+ * Level generation writes to the same arrays as the game, so this runs on
+ * the main thread, and the caller stops as soon as a key is ready.  It is
+ * skipped while recording or playing a replay, since what it does depends
+ * on how long the player pauses.
+ *
+ * Returns TRUE if a level was made.
+ */
+bool level_cache_spare(void)
+{
+	snapshot_type *s_ptr;
+	int want[3], num = 0;
+	int i, j, depth = 0;
+
+	u32b old_update, old_redraw, old_window;
+
+	u16b gen_place;
+	u32b gen_state[RAND_DEG];
+
+
+	/* Only between turns of a normal game */
+	if (!character_dungeon || p_ptr->leaving || p_ptr->is_dead) return (FALSE);
+
+	/* Not while recording or playing a replay */
+	if (replay_recording() || replay_playing()) return (FALSE);
+
+	/* Paranoia -- not while a level is being made */
+	if (Rand_stream == RAND_STREAM_GEN) return (FALSE);
+
+
+	/* The levels one up, one down, and at the recall depth */
+	if (p_ptr->depth > 1) want[num++] = p_ptr->depth - 1;
+	if (p_ptr->depth < MAX_DEPTH - 1) want[num++] = p_ptr->depth + 1;
+	if ((p_ptr->max_depth > 0) && (ABS(p_ptr->max_depth - p_ptr->depth) > 1))
+	{
+		want[num++] = p_ptr->max_depth;
+	}
+
+	/* Forget spare levels the player can no longer go to directly */
+	for (i = 0; i < LEVEL_CACHE_MAX; i++)
+	{
+		if (!level_cache[i].spare) continue;
+
+		for (j = 0; (j < num) && (want[j] != level_cache[i].depth); j++) /* loop */;
+
+		if (j == num) level_cache_free(&level_cache[i]);
+	}
+
+	/* Find a depth with no level ready */
+	for (j = 0; (j < num) && !depth; j++)
+	{
+		depth = want[j];
+
+		for (i = 0; i < LEVEL_CACHE_MAX; i++)
+		{
+			if (level_cache[i].depth == depth) depth = 0;
+		}
+	}
+
+	/* Nothing to do */
+	if (!depth) return (FALSE);
+
+
+	/* Remember everything */
+	old_update = p_ptr->update;
+	old_redraw = p_ptr->redraw;
+	old_window = p_ptr->window;
+	s_ptr = snapshot_take();
+
+	/* Leave the level, as "dungeon()" would */
+	wipe_o_list();
+	wipe_m_list();
+
+	/* Make the new one, without a word about it to the player */
+	msg_silent = TRUE;
+	p_ptr->depth = depth;
+	generate_cave();
+
+	/* Keep it */
+	level_cache_put(depth, TRUE);
+	msg_silent = FALSE;
+
+	/* Remember where level generation got to */
+	gen_place = Rand_stream_place[RAND_STREAM_GEN];
+	for (i = 0; i < RAND_DEG; i++)
+	{
+		gen_state[i] = Rand_stream_state[RAND_STREAM_GEN][i];
+	}
+
+	/* Put everything back */
+	(void)snapshot_restore(s_ptr);
+	snapshot_free(s_ptr);
+
+	/* Nothing needs recalculating or redrawing */
+	p_ptr->update = old_update;
+	p_ptr->redraw = old_redraw;
+	p_ptr->window = old_window;
+
+	/* Carry on from there next time */
+	Rand_stream_place[RAND_STREAM_GEN] = gen_place;
+	for (i = 0; i < RAND_DEG; i++)
+	{
+		Rand_stream_state[RAND_STREAM_GEN][i] = gen_state[i];
+	}
+
+	return (TRUE);
+}
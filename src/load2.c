@@ -10,6 +10,8 @@
 
 #include "angband.h"
 
+#include "compress.h"
+
 
 /*
  * This file loads savefiles from Angband 2.7.X and 2.8.X
@@ -50,6 +52,38 @@
  */
 static FILE	*fff;
 
+/*
+ * Savefile contents, read in a single block
+ */
+static byte	*sf_buf = NULL;
+
+/*
+ * Size of the savefile contents
+ */
+static u32b	sf_len = 0L;
+
+/*
+ * Current read position in the savefile contents
+ */
+static u32b	sf_pos = 0L;
+
+/*
+ * Hack -- tried to read past the end of the savefile
+ */
+static bool	sf_short = FALSE;
+
+/*
+ * Reading a decompressed section, which is neither encoded nor checksummed
+ */
+static bool	sf_plain = FALSE;
+
+/*
+ * The savefile contents, saved while reading a decompressed section
+ */
+static byte	*sf_outer_buf;
+static u32b	sf_outer_len;
+static u32b	sf_outer_pos;
+
 /*
  * Hack -- old "encryption" byte
  */
@@ -155,14 +189,29 @@ static bool wearable_p(const object_type *o_ptr)
 /*
  * The following functions are used to load the basic building blocks
  * of savefiles.  They also maintain the "checksum" info for 2.7.0+
+ *
+ * The whole savefile is read into "sf_buf" before parsing, so these
+ * decode straight out of memory instead of calling "getc()" per byte.
  */
 
 static byte sf_get(void)
 {
 	byte c, v;
 
-	/* Get a character, decode the value */
-	c = getc(fff) & 0xFF;
+	/* Hack -- pretend the savefile is padded with zeros */
+	if (sf_pos >= sf_len)
+	{
+		sf_short = TRUE;
+		return (0);
+	}
+
+	/* Get a character */
+	c = sf_buf[sf_pos++];
+
+	/* Decompressed sections are not encoded */
+	if (sf_plain) return (c);
+
+	/* Decode the value */
 	v = c ^ xor_byte;
 	xor_byte = c;
 
@@ -174,6 +223,66 @@ static byte sf_get(void)
 	return (v);
 }
 
+/*
+ * Decode "n" bytes into "buf" (or discard them if "buf" is NULL)
+ *
+ * This is equivalent to "n" calls to "sf_get()", but keeps the
+ * decryption and checksum state in locals for the duration.
+ */
+static void sf_get_block(byte *buf, u32b n)
+{
+	const byte *s;
+
+	byte c, v;
+	byte xb = xor_byte;
+	u32b vc = v_check;
+	u32b xc = x_check;
+
+	u32b i;
+
+	/* Hack -- decode what remains of a truncated savefile */
+	if (n > sf_len - sf_pos)
+	{
+		sf_short = TRUE;
+
+		/* Pad with zeros */
+		if (buf) (void)C_WIPE(buf + (sf_len - sf_pos), n - (sf_len - sf_pos), byte);
+
+		/* Read the rest */
+		n = sf_len - sf_pos;
+	}
+
+	/* Decompressed sections are not encoded */
+	if (sf_plain)
+	{
+		if (buf) (void)C_COPY(buf, sf_buf + sf_pos, n, byte);
+		sf_pos += n;
+		return;
+	}
+
+	/* Decode the bytes */
+	s = sf_buf + sf_pos;
+	for (i = 0; i < n; i++)
+	{
+		c = s[i];
+		v = c ^ xb;
+		xb = c;
+
+		vc += v;
+		xc += c;
+
+		if (buf) buf[i] = v;
+	}
+
+	/* Advance */
+	sf_pos += n;
+
+	/* Save the state */
+	xor_byte = xb;
+	v_check = vc;
+	x_check = xc;
+}
+
 static void rd_byte(byte *ip)
 {
 	*ip = sf_get();
@@ -181,8 +290,12 @@ static void rd_byte(byte *ip)
 
 static void rd_u16b(u16b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u16b)(sf_get()) << 8);
+	byte b[2];
+
+	sf_get_block(b, 2);
+
+	(*ip) = b[0];
+	(*ip) |= ((u16b)(b[1]) << 8);
 }
 
 static void rd_s16b(s16b *ip)
@@ -192,10 +305,14 @@ static void rd_s16b(s16b *ip)
 
 static void rd_u32b(u32b *ip)
 {
-	(*ip) = sf_get();
-	(*ip) |= ((u32b)(sf_get()) << 8);
-	(*ip) |= ((u32b)(sf_get()) << 16);
-	(*ip) |= ((u32b)(sf_get()) << 24);
+	byte b[4];
+
+	sf_get_block(b, 4);
+
+	(*ip) = b[0];
+	(*ip) |= ((u32b)(b[1]) << 8);
+	(*ip) |= ((u32b)(b[2]) << 16);
+	(*ip) |= ((u32b)(b[3]) << 24);
 }
 
 static void rd_s32b(s32b *ip)
@@ -211,21 +328,49 @@ static void rd_string(char *str, int max)
 {
 	int i;
 
+	byte c, v;
+	byte xb = xor_byte;
+	u32b vc = v_check;
+	u32b xc = x_check;
+
 	/* Read the string */
 	for (i = 0; TRUE; i++)
 	{
-		byte tmp8u;
+		/* Hack -- truncated savefile */
+		if (sf_pos >= sf_len)
+		{
+			sf_short = TRUE;
+			v = 0;
+		}
+		/* Decompressed sections are not encoded */
+		else if (sf_plain)
+		{
+			v = sf_buf[sf_pos++];
+		}
 
-		/* Read a byte */
-		rd_byte(&tmp8u);
+		else
+		{
+			/* Decode a byte */
+			c = sf_buf[sf_pos++];
+			v = c ^ xb;
+			xb = c;
+
+			vc += v;
+			xc += c;
+		}
 
 		/* Collect string while legal */
-		if (i < max) str[i] = tmp8u;
+		if (i < max) str[i] = v;
 
 		/* End of string */
-		if (!tmp8u) break;
+		if (!v) break;
 	}
 
+	/* Save the state */
+	xor_byte = xb;
+	v_check = vc;
+	x_check = xc;
+
 	/* Terminate */
 	str[max-1] = '\0';
 }
@@ -236,10 +381,93 @@ static void rd_string(char *str, int max)
  */
 static void strip_bytes(int n)
 {
-	byte tmp8u;
-
 	/* Strip the bytes */
-	while (n--) rd_byte(&tmp8u);
+	if (n > 0) sf_get_block(NULL, (u32b)n);
+}
+
+
+/*
+ * Largest decompressed section we are willing to allocate
+ */
+#define MAX_SECTION_SIZE	0x1000000L
+
+
+/*
+ * Read a compressed section, and read from its decompressed contents
+ * until "rd_compressed_end()" is called.
+ *
+ * The section is a "u32b" uncompressed size, a "u32b" compressed size,
+ * and the compressed bytes (see "compress.c").
+ */
+static errr rd_compressed_begin(void)
+{
+	u32b raw_len, comp_len;
+
+	byte *comp;
+	byte *raw;
+
+	long len;
+
+
+	/* Read the sizes */
+	rd_u32b(&raw_len);
+	rd_u32b(&comp_len);
+
+	/* Paranoia */
+	if ((comp_len > sf_len - sf_pos) || (raw_len > MAX_SECTION_SIZE))
+	{
+		note("Invalid compressed section!");
+		return (-1);
+	}
+
+	/* Read the compressed data */
+	C_MAKE(comp, comp_len + 1, byte);
+	sf_get_block(comp, comp_len);
+
+	/* Decompress it */
+	C_MAKE(raw, raw_len + 1, byte);
+	len = decompress_block(comp, comp_len, raw, raw_len);
+
+	/* Done with the compressed data */
+	C_KILL(comp, comp_len + 1, byte);
+
+	/* Verify */
+	if (len != (long)raw_len)
+	{
+		C_KILL(raw, raw_len + 1, byte);
+		note("Corrupt compressed section!");
+		return (-1);
+	}
+
+	/* Remember the savefile */
+	sf_outer_buf = sf_buf;
+	sf_outer_len = sf_len;
+	sf_outer_pos = sf_pos;
+
+	/* Read from the section */
+	sf_buf = raw;
+	sf_len = raw_len;
+	sf_pos = 0L;
+	sf_plain = TRUE;
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * Go back to reading the savefile after "rd_compressed_begin()"
+ */
+static void rd_compressed_end(void)
+{
+	/* Free the section */
+	C_KILL(sf_buf, sf_len + 1, byte);
+
+	/* Back to the savefile */
+	sf_buf = sf_outer_buf;
+	sf_len = sf_outer_len;
+	sf_pos = sf_outer_pos;
+	sf_plain = FALSE;
 }
 
 
@@ -1107,16 +1335,21 @@ static errr rd_store(int n)
  */
 static void rd_randomizer(void)
 {
-	int i;
+	int i, s;
 
+	byte num;
 	u16b tmp16u;
+	u32b tmp32u;
 
 	/* Old version */
 	if (older_than(0, 0, 0)) return;
 
-	/* Tmp */
+	/* Algorithm (zero in older savefiles) */
 	rd_u16b(&tmp16u);
 
+	/* Hack -- use the old generator for anything unknown */
+	Rand_mode = (tmp16u < RAND_MODE_MAX) ? tmp16u : RAND_MODE_LEGACY;
+
 	/* Place */
 	rd_u16b(&Rand_place);
 
@@ -1126,6 +1359,32 @@ static void rd_randomizer(void)
 		rd_u32b(&Rand_state[i]);
 	}
 
+	/* The main stream is the active one */
+	Rand_stream = RAND_STREAM_MAIN;
+
+	/* Older savefiles -- seed the other streams from the main one */
+	Rand_streams_init(Rand_state[0] ^ Rand_state[RAND_DEG - 1]);
+
+	/* The other streams */
+	if (!older_than(0, 2, 5))
+	{
+		/* Number of streams */
+		rd_byte(&num);
+
+		/* Read them (ignoring any this version does not have) */
+		for (s = 1; s < num; s++)
+		{
+			rd_u16b(&tmp16u);
+			if (s < RAND_STREAM_MAX) Rand_stream_place[s] = tmp16u;
+
+			for (i = 0; i < RAND_DEG; i++)
+			{
+				rd_u32b(&tmp32u);
+				if (s < RAND_STREAM_MAX) Rand_stream_state[s][i] = tmp32u;
+			}
+		}
+	}
+
 	/* Accept */
 	Rand_quick = FALSE;
 }
@@ -2432,6 +2691,103 @@ static errr rd_dungeon_aux(s16b depth, s16b py, s16b px)
 }
 
 
+/*
+ * Read the cave arrays, run length encoded (pre-0.2.3 savefiles)
+ */
+static void rd_cave_rle(void)
+{
+	int i, y, x;
+
+	byte count;
+	byte tmp8u;
+
+
+	/*** Run length decoding ***/
+
+	/* Load the dungeon data */
+	for (x = y = 0; y < DUNGEON_HGT; )
+	{
+		/* Grab RLE info */
+		rd_byte(&count);
+		rd_byte(&tmp8u);
+
+		/* Apply the RLE info */
+		for (i = count; i > 0; i--)
+		{
+			/* Extract "info" */
+			cave_info[y][x] = tmp8u;
+
+			/* Advance/Wrap */
+			if (++x >= DUNGEON_WID)
+			{
+				/* Wrap */
+				x = 0;
+
+				/* Advance/Wrap */
+				if (++y >= DUNGEON_HGT) break;
+			}
+		}
+	}
+
+
+	/*** Run length decoding ***/
+
+	/* Load the dungeon data */
+	for (x = y = 0; y < DUNGEON_HGT; )
+	{
+		/* Grab RLE info */
+		rd_byte(&count);
+		rd_byte(&tmp8u);
+
+		/* Apply the RLE info */
+		for (i = count; i > 0; i--)
+		{
+			/* Extract "feat" */
+			cave_set_feat(y, x, tmp8u);
+
+			/* Advance/Wrap */
+			if (++x >= DUNGEON_WID)
+			{
+				/* Wrap */
+				x = 0;
+
+				/* Advance/Wrap */
+				if (++y >= DUNGEON_HGT) break;
+			}
+		}
+	}
+}
+
+
+/*
+ * Read the cave arrays, uncompressed (they are in a compressed section)
+ */
+static void rd_cave_raw(void)
+{
+	int y, x;
+
+	byte feat[DUNGEON_WID];
+
+
+	/* Load the "info" */
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		sf_get_block(cave_info[y], DUNGEON_WID);
+	}
+
+	/* Load the "feat" */
+	for (y = 0; y < DUNGEON_HGT; y++)
+	{
+		sf_get_block(feat, DUNGEON_WID);
+
+		for (x = 0; x < DUNGEON_WID; x++)
+		{
+			cave_set_feat(y, x, feat[x]);
+		}
+	}
+}
+
+
 /*
  * Read the dungeon
  *
@@ -2452,14 +2808,12 @@ static errr rd_dungeon_aux(s16b depth, s16b py, s16b px)
  */
 static errr rd_dungeon(void)
 {
-	int i, y, x;
+	int i;
 
 	s16b depth;
 	s16b py, px;
 	s16b ymax, xmax;
 
-	byte count;
-	byte tmp8u;
 	u16b tmp16u;
 
 	u16b limit;
@@ -2509,59 +2863,18 @@ static errr rd_dungeon(void)
 	}
 
 
-	/*** Run length decoding ***/
+	/*** Cave ***/
 
-	/* Load the dungeon data */
-	for (x = y = 0; y < DUNGEON_HGT; )
+	/* Uncompressed arrays */
+	if (!older_than(0, 2, 3))
 	{
-		/* Grab RLE info */
-		rd_byte(&count);
-		rd_byte(&tmp8u);
-
-		/* Apply the RLE info */
-		for (i = count; i > 0; i--)
-		{
-			/* Extract "info" */
-			cave_info[y][x] = tmp8u;
-
-			/* Advance/Wrap */
-			if (++x >= DUNGEON_WID)
-			{
-				/* Wrap */
-				x = 0;
-
-				/* Advance/Wrap */
-				if (++y >= DUNGEON_HGT) break;
-			}
-		}
+		rd_cave_raw();
 	}
 
-
-	/*** Run length decoding ***/
-
-	/* Load the dungeon data */
-	for (x = y = 0; y < DUNGEON_HGT; )
+	/* Run length encoded arrays */
+	else
 	{
-		/* Grab RLE info */
-		rd_byte(&count);
-		rd_byte(&tmp8u);
-
-		/* Apply the RLE info */
-		for (i = count; i > 0; i--)
-		{
-			/* Extract "feat" */
-			cave_set_feat(y, x, tmp8u);
-
-			/* Advance/Wrap */
-			if (++x >= DUNGEON_WID)
-			{
-				/* Wrap */
-				x = 0;
-
-				/* Advance/Wrap */
-				if (++y >= DUNGEON_HGT) break;
-			}
-		}
+		rd_cave_rle();
 	}
 
 
@@ -2741,6 +3054,8 @@ static errr rd_savefile_new_aux(void)
 	byte pod; 
 	byte ppi;
 
+	errr err;
+
 
 #ifdef VERIFY_CHECKSUMS
 	u32b n_x_check, n_v_check;
@@ -2759,6 +3074,13 @@ static errr rd_savefile_new_aux(void)
 		note("Warning -- converting obsolete save file.");
 	}
 
+	/* Hack -- Refuse savefiles from the future */
+	if (!older_than(SAVEFILE_MAJOR, SAVEFILE_MINOR, SAVEFILE_PATCH + 1))
+	{
+		note("Savefile is from a newer version!");
+		return (-1);
+	}
+
 
 	/* Strip the version bytes */
 	strip_bytes(4);
@@ -2766,6 +3088,27 @@ static errr rd_savefile_new_aux(void)
 	/* Hack -- decrypt */
 	xor_byte = sf_extra;
 
+	/* Skip the summary chunk, which is stored as is */
+	if (!older_than(0, 2, 4))
+	{
+		u32b len;
+
+		if (sf_pos + 2 > sf_len)
+		{
+			note("Savefile is truncated");
+			return (-1);
+		}
+
+		len = sf_buf[sf_pos] | ((u32b)sf_buf[sf_pos + 1] << 8);
+		sf_pos += 2 + len;
+
+		if (sf_pos > sf_len)
+		{
+			note("Savefile is truncated");
+			return (-1);
+		}
+	}
+
 
 	/* Clear the checksums */
 	v_check = 0L;
@@ -2981,7 +3324,24 @@ static errr rd_savefile_new_aux(void)
 	{
 		/* Dead players have no dungeon */
 		note("Restoring Dungeon...");
-		if (rd_dungeon())
+
+		/* The dungeon is compressed (0.2.3) */
+		if (!older_than(0, 2, 3))
+		{
+			if (rd_compressed_begin()) return (-1);
+
+			err = rd_dungeon();
+
+			rd_compressed_end();
+		}
+
+		/* The dungeon is not compressed */
+		else
+		{
+			err = rd_dungeon();
+		}
+
+		if (err)
 		{
 			note("Error reading dungeon data");
 			return (-1);
@@ -3055,15 +3415,51 @@ errr rd_savefile_new(void)
 	/* Paranoia */
 	if (!fff) return (-1);
 
-	/* Call the sub-function */
-	err = rd_savefile_new_aux();
+	/* Get the size of the savefile */
+	err = -1;
+	if (!fseek(fff, 0L, SEEK_END))
+	{
+		long size = ftell(fff);
+
+		if ((size > 0) && !fseek(fff, 0L, SEEK_SET))
+		{
+			sf_len = (u32b)size;
+			err = 0;
+		}
+	}
+
+	/* Read the whole savefile in one block */
+	if (!err)
+	{
+		C_MAKE(sf_buf, sf_len, byte);
 
-	/* Check for errors */
-	if (ferror(fff)) err = -1;
+		if (fread(sf_buf, 1, sf_len, fff) != sf_len) err = -1;
+	}
 
 	/* Close the file */
 	my_fclose(fff);
 
+	/* Parse the savefile */
+	if (!err)
+	{
+		sf_pos = 0L;
+		sf_short = FALSE;
+
+		/* Call the sub-function */
+		err = rd_savefile_new_aux();
+
+		/* Ran off the end of the savefile */
+		if (sf_short)
+		{
+			note("Savefile is truncated");
+			err = -1;
+		}
+	}
+
+	/* Free the contents */
+	if (sf_buf) C_KILL(sf_buf, sf_len, byte);
+	sf_len = 0L;
+
 	/* Result */
 	return (err);
 }
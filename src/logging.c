@@ -105,6 +105,15 @@ static int ensure_directory_exists(const char *filepath) {
     return 0;
 }
 
+/* Name the rotated log file "n" (empty if the name does not fit) */
+static void rotated_log_path(char *buf, size_t size, int n) {
+    int len = snprintf(buf, size, "%s.%d", log_file_path, n);
+    
+    if (len < 0 || (size_t)len >= size) {
+        buf[0] = '\0';
+    }
+}
+
 /* Rotate log files when size exceeds threshold */
 static void rotate_log_file(void) {
     char old_path[1024];
@@ -120,20 +129,18 @@ static void rotate_log_file(void) {
     log_file = NULL;
     
     /* Delete oldest file (steamband.log.5) */
-    snprintf(old_path, sizeof(old_path), "%s.5", log_file_path);
-    old_path[sizeof(old_path) - 1] = '\0';
+    rotated_log_path(old_path, sizeof(old_path), LOG_ROTATION_COUNT);
     remove(old_path);
     
     /* Rotate files: .4 -> .5, .3 -> .4, ..., .1 -> .2, current -> .1 */
     for (i = LOG_ROTATION_COUNT - 1; i >= 1; i--) {
         if (i == LOG_ROTATION_COUNT - 1) {
-            snprintf(old_path, sizeof(old_path), "%s.%d", log_file_path, i);
+            rotated_log_path(old_path, sizeof(old_path), i);
         } else {
             strncpy(old_path, new_path, sizeof(old_path) - 1);
             old_path[sizeof(old_path) - 1] = '\0';
         }
-        snprintf(new_path, sizeof(new_path), "%s.%d", log_file_path, i + 1);
-        new_path[sizeof(new_path) - 1] = '\0';
+        rotated_log_path(new_path, sizeof(new_path), i + 1);
         
         /* Rename file if it exists */
 #ifdef WINDOWS
@@ -146,8 +153,7 @@ static void rotate_log_file(void) {
     }
     
     /* Rename current log file to .1 */
-    snprintf(new_path, sizeof(new_path), "%s.1", log_file_path);
-    new_path[sizeof(new_path) - 1] = '\0';
+    rotated_log_path(new_path, sizeof(new_path), 1);
     rename(log_file_path, new_path);
     
     /* Open new log file */
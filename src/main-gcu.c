@@ -48,6 +48,8 @@
 
 #include "angband.h"
 
+#include "logging.h"
+
 
 #ifdef USE_GCU
 
@@ -200,6 +202,8 @@ struct term_data
 	term t;                 /* All term info */
 
 	WINDOW *win;            /* Pointer to the curses window */
+
+	int attr;               /* Current attribute (or -1 if unknown) */
 };
 
 /* Max number of windows on screen */
@@ -215,6 +219,21 @@ static term_data data[MAX_TERM_DATA];
 static int active = 0;
 
 
+/*
+ * Some windows have been refreshed, but not yet sent to the screen
+ */
+static bool gcu_pending = FALSE;
+
+
+/*
+ * Output statistics, logged on exit, to see what the screen costs
+ */
+static long gcu_calls = 0;      /* Calls to draw text */
+static long gcu_chars = 0;      /* Characters drawn */
+static long gcu_attrs = 0;      /* Changes of attribute */
+static long gcu_updates = 0;    /* Updates of the physical screen */
+
+
 #ifdef A_COLOR
 
 /*
@@ -450,6 +469,24 @@ static void keymap_game_prepare(void)
 
 
 
+/*
+ * Send all the refreshed windows to the screen at once
+ */
+static void Term_update_gcu(void)
+{
+	/* Nothing to do */
+	if (!gcu_pending) return;
+
+	/* Update the screen */
+	(void)doupdate();
+
+	/* Count updates */
+	gcu_updates++;
+
+	gcu_pending = FALSE;
+}
+
+
 /*
  * Suspend/Resume
  */
@@ -461,6 +498,9 @@ static errr Term_xtra_gcu_alive(int v)
 	/* Suspend */
 	if (!v)
 	{
+		/* Show any windows still waiting */
+		Term_update_gcu();
+
 		/* Go to normal keymap mode */
 		keymap_norm();
 
@@ -734,7 +774,11 @@ static errr Term_xtra_gcu(int n, int v)
 
 		/* Flush the Curses buffer */
 		case TERM_XTRA_FRESH:
-		(void)wrefresh(td->win);
+		(void)wnoutrefresh(td->win);
+		gcu_pending = TRUE;
+
+		/* The other windows wait for the main one */
+		if (td == &data[0]) Term_update_gcu();
 		return (0);
 
 #ifdef USE_CURS_SET
@@ -752,6 +796,7 @@ static errr Term_xtra_gcu(int n, int v)
 
 		/* Process events */
 		case TERM_XTRA_EVENT:
+		if (v) Term_update_gcu();
 		return (Term_xtra_gcu_event(v));
 
 		/* Flush events */
@@ -761,6 +806,7 @@ static errr Term_xtra_gcu(int n, int v)
 
 		/* Delay */
 		case TERM_XTRA_DELAY:
+		Term_update_gcu();
 		usleep(1000 * v);
 		return (0);
 
@@ -810,7 +856,9 @@ static errr Term_wipe_gcu(int x, int y, int n)
 	/* Clear some characters */
 	else
 	{
-		while (n-- > 0) waddch(td->win, ' ');
+		whline(td->win, ' ', n);
+		gcu_calls++;
+		gcu_chars += n;
 	}
 
 	/* Success */
@@ -825,25 +873,47 @@ static errr Term_text_gcu(int x, int y, int n, byte a, cptr s)
 {
 	term_data *td = (term_data *)(Term->data);
 
-	int i, pic;
+	int i, j, pic;
 
 #ifdef A_COLOR
-	/* Set the color */
-	if (can_use_color) wattrset(td->win, colortable[a & 0x0F]);
+	/* Set the color, unless it is set already */
+	if (can_use_color && (td->attr != colortable[a & 0x0F]))
+	{
+		td->attr = colortable[a & 0x0F];
+		wattrset(td->win, td->attr);
+		gcu_attrs++;
+	}
 #endif
 
 	/* Move the cursor */
 	wmove(td->win, y, x);
 
-	/* Draw each character */
-	for (i = 0; i < n; i++)
+	/* Draw each run of normal characters */
+	for (i = 0; i < n; i = j)
 	{
+		/* Find the end of the run */
+		for (j = i; j < n; j++)
+		{
+#ifdef USE_GRAPHICS
+			/* Special character */
+			if (use_graphics && (s[j] & 0x80)) break;
+#endif
+		}
+
+		/* Draw the run */
+		if (j > i)
+		{
+			waddnstr(td->win, s + i, j - i);
+			gcu_calls++;
+			gcu_chars += j - i;
+		}
+
 #ifdef USE_GRAPHICS
 		/* Special character */
-		if (use_graphics && (s[i] & 0x80))
+		if (j < n)
 		{
 			/* Determine picture to use */
-			switch (s[i] & 0x7F)
+			switch (s[j] & 0x7F)
 			{
 
 #ifdef ACS_CKBOARD
@@ -868,14 +938,13 @@ static errr Term_text_gcu(int x, int y, int n, byte a, cptr s)
 
 			/* Draw the picture */
 			waddch(td->win, pic);
+			gcu_calls++;
+			gcu_chars++;
 
 			/* Next character */
-			continue;
+			j++;
 		}
 #endif
-
-		/* Draw a normal character */
-		waddch(td->win, s[i]);
 	}
 
 	/* Success */
@@ -895,6 +964,9 @@ static errr term_data_init_gcu(term_data *td, int rows, int cols, int y, int x)
 	/* Create new window */
 	td->win = newwin(rows, cols, y, x);
 
+	/* Attribute not known yet */
+	td->attr = -1;
+
 	/* Check for failure */
 	if (!td->win)
 	{
@@ -940,6 +1012,10 @@ static void hook_quit(cptr str)
 
 	/* Exit curses */
 	endwin();
+
+	/* Report the output statistics */
+	LOG_I("Curses: %ld chars in %ld calls, %ld attribute changes, %ld updates",
+	      gcu_chars, gcu_calls, gcu_attrs, gcu_updates);
 }
 
 
@@ -0,0 +1,552 @@
+/* File: main-sck.c */
+
+/*
+ * This file lets Angband be watched and played over a Unix domain socket.
+ *
+ *
+ * To use this file, you must define "USE_SCK" in the Makefile, and ask
+ * for it with "-msck".  The socket is called "steamband.sock", in the
+ * current directory, unless another path is given with "-- -s<path>".
+ *
+ *
+ * The game draws on a single 80x24 term, which is never shown locally.
+ * Instead, the changes made by each "Term_fresh()" are sent to the client
+ * (if any) as compact binary messages, described in "main-sck.h", and the
+ * bytes sent back by the client are used as keypresses.  Since "z-term.c"
+ * only asks us to draw the grids which have changed, a frame costs little
+ * more than one byte per changed grid.
+ *
+ * One client is served at a time; a new connection replaces the old one,
+ * and is sent the whole screen to start with.  While nobody is connected,
+ * the game simply waits for a key, as it would at a terminal.
+ *
+ * See "sckclient.c" for a simple client.
+ */
+
+
+#include "angband.h"
+
+
+#ifdef USE_SCK
+
+#include "logging.h"
+#include "main-sck.h"
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/select.h>
+#include <errno.h>
+
+
+/*
+ * Some systems cannot be told not to raise SIGPIPE per call
+ */
+#ifndef MSG_NOSIGNAL
+# define MSG_NOSIGNAL 0
+#endif
+
+
+/*
+ * Size of the output buffer (several frames of changes)
+ */
+#define SCK_BUF_SIZE	4096
+
+
+/*
+ * Information about the term
+ */
+typedef struct term_data term_data;
+
+struct term_data
+{
+	term t;                 /* All term info */
+
+	int listen_fd;          /* Socket waiting for clients */
+	int client_fd;          /* Connected client (or -1) */
+
+	char path[1024];        /* Name of the socket */
+
+	char buf[SCK_BUF_SIZE]; /* Output waiting to be sent */
+	int buf_n;              /* Number of bytes waiting */
+};
+
+/* Information about our (only) window */
+static term_data data;
+
+
+/*
+ * Output statistics, logged on exit, to see what the frames cost
+ */
+static long sck_frames = 0;     /* Frames sent */
+static long sck_grids = 0;      /* Grids sent */
+static long sck_bytes = 0;      /* Bytes sent */
+
+
+
+/*
+ * Forget the client
+ */
+static void sck_drop(term_data *td)
+{
+	/* Nothing to do */
+	if (td->client_fd < 0) return;
+
+	/* Close the connection */
+	(void)close(td->client_fd);
+	td->client_fd = -1;
+
+	/* Forget any output */
+	td->buf_n = 0;
+
+	LOG_I("Socket: Client disconnected");
+}
+
+
+/*
+ * Send the waiting output to the client
+ */
+static void sck_flush(term_data *td)
+{
+	int i = 0;
+
+	/* Send everything */
+	while (i < td->buf_n)
+	{
+		int n = send(td->client_fd, td->buf + i, td->buf_n - i, MSG_NOSIGNAL);
+
+		/* Interrupted */
+		if ((n < 0) && (errno == EINTR)) continue;
+
+		/* The client has gone */
+		if (n <= 0)
+		{
+			sck_drop(td);
+			return;
+		}
+
+		i += n;
+	}
+
+	/* Count the bytes */
+	sck_bytes += td->buf_n;
+
+	td->buf_n = 0;
+}
+
+
+/*
+ * Queue a message for the client
+ */
+static void sck_send(term_data *td, const char *s, int n)
+{
+	/* Nobody is listening */
+	if (td->client_fd < 0) return;
+
+	/* Make room */
+	if (td->buf_n + n > SCK_BUF_SIZE) sck_flush(td);
+
+	/* The client may have gone */
+	if (td->client_fd < 0) return;
+
+	/* Queue the message */
+	memcpy(td->buf + td->buf_n, s, n);
+	td->buf_n += n;
+}
+
+
+/*
+ * Queue a "text" message
+ */
+static void sck_send_text(term_data *td, int x, int y, int n, byte a, cptr s)
+{
+	char head[5];
+
+	head[0] = SCK_TEXT;
+	head[1] = y;
+	head[2] = x;
+	head[3] = n;
+	head[4] = a;
+
+	sck_send(td, head, 5);
+	sck_send(td, s, n);
+
+	/* Count the grids */
+	sck_grids += n;
+}
+
+
+/*
+ * Accept a new client, and send it the whole screen
+ */
+static void sck_accept(term_data *td)
+{
+	term_win *scr = td->t.scr;
+
+	char msg[4];
+
+	int fd, y, x, x1;
+
+	/* Accept the connection */
+	fd = accept(td->listen_fd, NULL, NULL);
+
+	/* Failure */
+	if (fd < 0) return;
+
+	/* Only one client at a time */
+	sck_drop(td);
+	td->client_fd = fd;
+
+	LOG_I("Socket: Client connected");
+
+	/* Hello */
+	msg[0] = SCK_HELLO;
+	msg[1] = SCK_VERSION;
+	msg[2] = td->t.hgt;
+	msg[3] = td->t.wid;
+	sck_send(td, msg, 4);
+
+	/* Send each row, as runs of one attribute */
+	for (y = 0; y < td->t.hgt; y++)
+	{
+		for (x1 = 0; x1 < td->t.wid; x1 = x)
+		{
+			/* Find the end of the run */
+			for (x = x1; x < td->t.wid; x++)
+			{
+				if (scr->a[y][x] != scr->a[y][x1]) break;
+			}
+
+			/* Send the run */
+			sck_send_text(td, x1, y, x - x1, scr->a[y][x1], &scr->c[y][x1]);
+		}
+	}
+
+	/* The cursor */
+	msg[0] = SCK_CURS;
+	msg[1] = scr->cy;
+	msg[2] = scr->cx;
+	sck_send(td, msg, 3);
+
+	msg[0] = SCK_SHAPE;
+	msg[1] = scr->cv;
+	sck_send(td, msg, 2);
+
+	/* End of the frame */
+	msg[0] = SCK_FRAME;
+	sck_send(td, msg, 1);
+
+	/* Send it */
+	sck_flush(td);
+}
+
+
+/*
+ * Process events, with optional wait
+ */
+static errr Term_xtra_sck_event(int v)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	while (TRUE)
+	{
+		fd_set fds;
+		struct timeval tv;
+		int max_fd = td->listen_fd;
+
+		/* Listen for clients */
+		FD_ZERO(&fds);
+		FD_SET(td->listen_fd, &fds);
+
+		/* Listen to the client */
+		if (td->client_fd >= 0)
+		{
+			FD_SET(td->client_fd, &fds);
+			if (td->client_fd > max_fd) max_fd = td->client_fd;
+		}
+
+		/* Do not wait, unless asked to */
+		tv.tv_sec = 0;
+		tv.tv_usec = 0;
+
+		/* Wait for something to happen */
+		if (select(max_fd + 1, &fds, NULL, NULL, v ? NULL : &tv) <= 0)
+		{
+			/* Interrupted */
+			if (v && (errno == EINTR)) continue;
+
+			/* Nothing happened */
+			return (1);
+		}
+
+		/* A new client */
+		if (FD_ISSET(td->listen_fd, &fds)) sck_accept(td);
+
+		/* Keypresses */
+		if ((td->client_fd >= 0) && FD_ISSET(td->client_fd, &fds))
+		{
+			char keys[64];
+			int i, n;
+
+			/* Read the keys */
+			n = recv(td->client_fd, keys, sizeof(keys), 0);
+
+			/* The client has gone */
+			if (n <= 0)
+			{
+				sck_drop(td);
+			}
+
+			/* Enqueue the keypresses */
+			else
+			{
+				for (i = 0; i < n; i++) Term_keypress((byte)keys[i]);
+
+				/* Success */
+				return (0);
+			}
+		}
+
+		/* Nothing to return */
+		if (!v) return (1);
+	}
+}
+
+
+/*
+ * Handle a "special request"
+ */
+static errr Term_xtra_sck(int n, int v)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	char msg[2];
+
+	/* Analyze the request */
+	switch (n)
+	{
+		/* Clear screen */
+		case TERM_XTRA_CLEAR:
+		msg[0] = SCK_CLEAR;
+		sck_send(td, msg, 1);
+		return (0);
+
+		/* Make a noise */
+		case TERM_XTRA_NOISE:
+		msg[0] = SCK_BELL;
+		sck_send(td, msg, 1);
+		return (0);
+
+		/* Send the frame */
+		case TERM_XTRA_FRESH:
+		msg[0] = SCK_FRAME;
+		sck_send(td, msg, 1);
+		if (td->client_fd >= 0)
+		{
+			sck_flush(td);
+			sck_frames++;
+		}
+		return (0);
+
+		/* Change the cursor visibility */
+		case TERM_XTRA_SHAPE:
+		msg[0] = SCK_SHAPE;
+		msg[1] = (v ? 1 : 0);
+		sck_send(td, msg, 2);
+		return (0);
+
+		/* Process events */
+		case TERM_XTRA_EVENT:
+		return (Term_xtra_sck_event(v));
+
+		/* Flush events */
+		case TERM_XTRA_FLUSH:
+		while (!Term_xtra_sck_event(FALSE));
+		return (0);
+
+		/* Delay */
+		case TERM_XTRA_DELAY:
+		usleep(1000 * v);
+		return (0);
+	}
+
+	/* Unknown */
+	return (1);
+}
+
+
+/*
+ * Move the cursor
+ */
+static errr Term_curs_sck(int x, int y)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	char msg[3];
+
+	msg[0] = SCK_CURS;
+	msg[1] = y;
+	msg[2] = x;
+	sck_send(td, msg, 3);
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * Erase some grids
+ */
+static errr Term_wipe_sck(int x, int y, int n)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	char msg[4];
+
+	msg[0] = SCK_WIPE;
+	msg[1] = y;
+	msg[2] = x;
+	msg[3] = n;
+	sck_send(td, msg, 4);
+
+	/* Count the grids */
+	sck_grids += n;
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * Draw some text
+ */
+static errr Term_text_sck(int x, int y, int n, byte a, cptr s)
+{
+	term_data *td = (term_data*)(Term->data);
+
+	sck_send_text(td, x, y, n, a, s);
+
+	/* Success */
+	return (0);
+}
+
+
+/*
+ * Close the socket on exit
+ */
+static void hook_quit(cptr str)
+{
+	term_data *td = &data;
+
+	/* Unused */
+	(void)str;
+
+	/* Send whatever is left */
+	if (td->client_fd >= 0) sck_flush(td);
+
+	/* Close the sockets */
+	sck_drop(td);
+	(void)close(td->listen_fd);
+	(void)unlink(td->path);
+
+	/* Report the output statistics */
+	LOG_I("Socket: %ld frames, %ld grids, %ld bytes", sck_frames,
+	      sck_grids, sck_bytes);
+}
+
+
+/*
+ * Prepare the socket for use by the file "z-term.c"
+ */
+errr init_sck(int argc, char *argv[])
+{
+	term_data *td = &data;
+	term *t = &td->t;
+
+	struct sockaddr_un addr;
+
+	int i;
+
+
+	/* Default socket */
+	my_strcpy(td->path, SCK_PATH, sizeof(td->path));
+
+	/* Parse args */
+	for (i = 1; i < argc; i++)
+	{
+		if (prefix(argv[i], "-s") && argv[i][2])
+		{
+			my_strcpy(td->path, &argv[i][2], sizeof(td->path));
+			continue;
+		}
+
+		plog_fmt("Ignoring option: %s", argv[i]);
+	}
+
+	/* Paranoia -- the name must fit */
+	if (strlen(td->path) >= sizeof(addr.sun_path))
+	{
+		plog_fmt("Socket name too long: %s", td->path);
+		return (-1);
+	}
+
+	/* Create the socket */
+	td->listen_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+	td->client_fd = -1;
+
+	/* Failure */
+	if (td->listen_fd < 0) return (-1);
+
+	/* Remove any socket left by an earlier game */
+	(void)unlink(td->path);
+
+	/* Listen on it */
+	(void)memset(&addr, 0, sizeof(addr));
+	addr.sun_family = AF_UNIX;
+	my_strcpy(addr.sun_path, td->path, sizeof(addr.sun_path));
+
+	if ((bind(td->listen_fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) ||
+	    (listen(td->listen_fd, 1) < 0))
+	{
+		plog_fmt("Cannot listen on %s", td->path);
+		(void)close(td->listen_fd);
+		return (-1);
+	}
+
+	LOG_I("Socket: Listening on %s", td->path);
+
+	/* Close the socket on exit */
+	quit_aux = hook_quit;
+	core_aux = hook_quit;
+
+
+	/* Initialize the term */
+	term_init(t, 80, 24, 256);
+
+	/* Erase with "white space" */
+	t->attr_blank = TERM_WHITE;
+	t->char_blank = ' ';
+
+	/* Set some hooks */
+	t->text_hook = Term_text_sck;
+	t->wipe_hook = Term_wipe_sck;
+	t->curs_hook = Term_curs_sck;
+	t->xtra_hook = Term_xtra_sck;
+
+	/* Save the data */
+	t->data = td;
+
+	/* Activate it */
+	Term_activate(t);
+
+	/* Remember the term */
+	angband_term[0] = t;
+
+	/* Remember the active screen */
+	term_screen = t;
+
+	/* Success */
+	return (0);
+}
+
+
+#endif /* USE_SCK */
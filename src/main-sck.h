@@ -0,0 +1,46 @@
+/* File: main-sck.h */
+
+/*
+ * The protocol spoken by "main-sck.c" and its clients
+ */
+
+#ifndef INCLUDED_MAIN_SCK_H
+#define INCLUDED_MAIN_SCK_H
+
+/*
+ * Protocol version, sent in the "hello" message
+ */
+#define SCK_VERSION	1
+
+/*
+ * Default name of the socket
+ */
+#define SCK_PATH	"steamband.sock"
+
+/*
+ * Messages from the game (every number is a single byte)
+ *
+ *   'H' version rows cols   Hello (the first message on a connection)
+ *   'T' y x n attr chars    "n" characters drawn in one attribute
+ *   'W' y x n               "n" grids erased
+ *   'C' y x                 The cursor was moved
+ *   'V' visible             The cursor was hidden (0) or shown (1)
+ *   'K'                     The screen was cleared
+ *   'B'                     A bell
+ *   'F'                     End of a frame (the client may now draw)
+ *
+ * Only the grids changed since the last frame are sent (see "Term_fresh()"),
+ * so a frame costs a few bytes more than the number of changed grids.
+ *
+ * The client sends back keypresses, one byte each.
+ */
+#define SCK_HELLO	'H'
+#define SCK_TEXT	'T'
+#define SCK_WIPE	'W'
+#define SCK_CURS	'C'
+#define SCK_SHAPE	'V'
+#define SCK_CLEAR	'K'
+#define SCK_BELL	'B'
+#define SCK_FRAME	'F'
+
+#endif /* INCLUDED_MAIN_SCK_H */
@@ -75,6 +75,7 @@
 #include "controller.h"
 #include "steam_integration.h"
 #include "logging.h"
+#include "profile.h"
 
 
 #ifdef WINDOWS
@@ -5361,7 +5362,9 @@ static void init_stuff(void)
 	validate_dir(path);
 
 	/* Init the file paths */
+	profile_begin("init_file_paths");
 	init_file_paths(path);
+	profile_end();
 
 	/* Hack -- Validate the paths */
 	validate_dir(ANGBAND_DIR_APEX);
@@ -10,6 +10,9 @@
 
 #include "angband.h"
 
+#include "profile.h"
+#include "save_summary.h"
+
 
 /*
  * Some machines have a "main()" function in their "main-xxx.c" file,
@@ -94,6 +97,69 @@ static void create_user_dir(void)
 #endif /* PRIVATE_USER_PATH */
 
 
+#ifdef SET_UID
+
+#include <dirent.h>
+
+/*
+ * List the characters in the savefile directory.
+ *
+ * Only the summary at the start of each savefile is read, so this is
+ * quick even with lots of savefiles.  Savefiles too old to have a
+ * summary are listed by name only.
+ */
+static void list_savefiles(void)
+{
+	DIR *dir;
+	struct dirent *entry;
+	char path[1024];
+	save_summary sum;
+	int n = 0;
+
+	/* Grab permissions */
+	safe_setuid_grab();
+
+	dir = opendir(ANGBAND_DIR_SAVE);
+
+	if (!dir)
+	{
+		safe_setuid_drop();
+		quit_fmt("Cannot open the savefile directory '%s'", ANGBAND_DIR_SAVE);
+	}
+
+	while ((entry = readdir(dir)) != NULL)
+	{
+		/* Skip hidden files and temporary savefiles */
+		if (entry->d_name[0] == '.') continue;
+		if (suffix(entry->d_name, ".new")) continue;
+
+		path_build(path, 1024, ANGBAND_DIR_SAVE, entry->d_name);
+
+		if (save_summary_probe(path, &sum) == 0)
+		{
+			printf("%-24s %-20s the %s %s, level %d, %d ft, turn %ld%s\n",
+			       entry->d_name, sum.name, sum.race, sum.pclass, sum.lev,
+			       sum.depth * 50, sum.turn, sum.is_dead ? " (dead)" : "");
+		}
+		else
+		{
+			printf("%-24s (no summary)\n", entry->d_name);
+		}
+
+		n++;
+	}
+
+	closedir(dir);
+
+	/* Drop permissions */
+	safe_setuid_drop();
+
+	if (!n) puts("No savefiles.");
+}
+
+#endif /* SET_UID */
+
+
 /*
  * Initialize and verify the file paths, and the score file.
  *
@@ -287,6 +353,8 @@ int main(int argc, char *argv[])
 
 	int show_score = 0;
 
+	bool list_saves = FALSE;
+
 	cptr mstr = NULL;
 
 	bool args = TRUE;
@@ -319,7 +387,9 @@ int main(int argc, char *argv[])
 
 
 	/* Get the file paths */
+	profile_begin("init_file_paths");
 	init_stuff();
+	profile_end();
 
 
 #ifdef SET_UID
@@ -461,6 +531,15 @@ int main(int argc, char *argv[])
 				break;
 			}
 
+#ifdef SET_UID
+			case 'L':
+			case 'l':
+			{
+				list_saves = TRUE;
+				break;
+			}
+#endif /* SET_UID */
+
 			case 'u':
 			case 'U':
 			{
@@ -512,6 +591,9 @@ int main(int argc, char *argv[])
 				puts("  -o       Request original keyset");
 				puts("  -r       Request rogue-like keyset");
 				puts("  -s<num>  Show <num> high scores");
+#ifdef SET_UID
+				puts("  -l       List saved characters");
+#endif /* SET_UID */
 				puts("  -u<who>  Use your <who> savefile");
 				puts("  -m<sys>  Force 'main-<sys>.c' usage");
 				puts("  -d<def>  Define a 'lib' dir sub-path");
@@ -529,6 +611,17 @@ int main(int argc, char *argv[])
 		argv[1] = NULL;
 	}
 
+#ifdef SET_UID
+
+	/* List the saved characters, and stop */
+	if (list_saves)
+	{
+		list_savefiles();
+		quit(NULL);
+	}
+
+#endif /* SET_UID */
+
 
 	/* Process the player name */
 	process_player_name(TRUE);
@@ -622,6 +715,20 @@ int main(int argc, char *argv[])
 #endif /* USE_CAP */
 
 
+#ifdef USE_SCK
+	/* Attempt to use the "main-sck.c" support (only when asked for) */
+	if (!done && mstr && (streq(mstr, "sck")))
+	{
+		extern errr init_sck(int argc, char** argv);
+		if (0 == init_sck(argc, argv))
+		{
+			ANGBAND_SYS = "sck";
+			done = TRUE;
+		}
+	}
+#endif /* USE_SCK */
+
+
 #ifdef USE_DOS
 	/* Attempt to use the "main-dos.c" support */
 	if (!done && (!mstr || (streq(mstr, "dos"))))
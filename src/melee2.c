@@ -5257,6 +5257,7 @@ void process_monsters(byte minimum_energy)
 {
 	int i;
 	int fy, fx;
+	int old_stream;
 
 	monster_type *m_ptr;
 	monster_race *r_ptr;
@@ -5283,6 +5284,9 @@ void process_monsters(byte minimum_energy)
 	}
 
 
+	/* Monsters roll their dice on a stream of their own */
+	old_stream = Rand_stream_set(RAND_STREAM_AI);
+
 	/* Process the monsters (backwards) */
 	for (i = m_max - 1; i >= 1; i--)
 	{
@@ -5372,4 +5376,7 @@ void process_monsters(byte minimum_energy)
 #endif /* MONSTER_FLOW */
 
 	}
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
@@ -2045,7 +2045,8 @@ void mutation_power_aux(u32b power)
 
 		default:
 			p_ptr->energy_use = 0;
-			msg_format("Power %s not implemented. Oops.", power);
+			msg_format("Power 0x%08lx not implemented. Oops.",
+			           (unsigned long)power);
 	}
 
 }
@@ -157,7 +157,7 @@ void delete_object_idx(int o_idx)
 		x = j_ptr->ix;
 
 		/* Visual update */
-		lite_spot(y, x);
+		dirty_spot(y, x);
 	}
 
 	/* Wipe the object */
@@ -202,7 +202,7 @@ void delete_object(int y, int x)
 	cave_o_idx[y][x] = 0;
 
 	/* Visual update */
-	lite_spot(y, x);
+	dirty_spot(y, x);
 }
 
 
@@ -3046,7 +3046,7 @@ s16b floor_carry(int y, int x, object_type *j_ptr)
 		note_spot(y, x);
 
 		/* Redraw */
-		lite_spot(y, x);
+		dirty_spot(y, x);
 	}
 
 	/* Result */
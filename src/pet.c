@@ -253,7 +253,8 @@ void do_cmd_pet(void)
 					{
 						char friend_name[80], check_friend[80];
 						monster_desc(friend_name, m_ptr, 0x80);
-						sprintf(check_friend, "Dismiss %s? ", friend_name);
+						strnfmt(check_friend, sizeof(check_friend),
+						        "Dismiss %s? ", friend_name);
 
 						if (get_check(check_friend))
 							delete_this = TRUE;
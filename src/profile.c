@@ -0,0 +1,167 @@
+/* File: profile.c */
+#include "profile.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#ifdef WINDOWS
+#include <windows.h>
+#endif
+
+static profile_phase phases[PROFILE_MAX_PHASES];
+static int num_phases = 0;
+
+/* Indexes into phases[] of the currently running phases */
+static int open_phase[PROFILE_MAX_DEPTH];
+static int num_open = 0;
+
+/* Nesting depth of phases that did not fit in phases[] or open_phase[] */
+static int num_dropped = 0;
+
+/* Timestamp of the first phase */
+static double origin_ms = 0.0;
+
+double profile_now_ms(void) {
+#ifdef WINDOWS
+    static LARGE_INTEGER freq;
+    LARGE_INTEGER now;
+
+    if (!freq.QuadPart) {
+        QueryPerformanceFrequency(&freq);
+    }
+    QueryPerformanceCounter(&now);
+
+    return (double)now.QuadPart * 1000.0 / (double)freq.QuadPart;
+#elif defined(CLOCK_MONOTONIC)
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec * 1000.0 + (double)ts.tv_nsec / 1000000.0;
+#else
+    return (double)clock() * 1000.0 / (double)CLOCKS_PER_SEC;
+#endif
+}
+
+void profile_begin(const char *name) {
+    double now = profile_now_ms();
+    profile_phase *ph;
+
+    /* Out of room - still track the nesting so profile_end() pairs up */
+    if (num_dropped || num_phases >= PROFILE_MAX_PHASES ||
+        num_open >= PROFILE_MAX_DEPTH) {
+        num_dropped++;
+        return;
+    }
+
+    if (!num_phases) {
+        origin_ms = now;
+    }
+
+    ph = &phases[num_phases];
+    ph->name = name;
+    ph->depth = num_open;
+    ph->start_ms = now - origin_ms;
+    ph->elapsed_ms = -1.0;
+
+    open_phase[num_open++] = num_phases++;
+}
+
+void profile_end(void) {
+    double now = profile_now_ms();
+    profile_phase *ph;
+
+    if (num_dropped) {
+        num_dropped--;
+        return;
+    }
+
+    /* Unbalanced call */
+    if (!num_open) {
+        return;
+    }
+
+    ph = &phases[open_phase[--num_open]];
+    ph->elapsed_ms = (now - origin_ms) - ph->start_ms;
+}
+
+void profile_reset(void) {
+    num_phases = 0;
+    num_open = 0;
+    num_dropped = 0;
+    origin_ms = 0.0;
+}
+
+int profile_phase_count(void) {
+    return num_phases;
+}
+
+const profile_phase *profile_phase_get(int i) {
+    if (i < 0 || i >= num_phases) {
+        return NULL;
+    }
+    return &phases[i];
+}
+
+/* Write a string as a JSON string literal */
+static void write_json_string(FILE *fp, const char *s) {
+    fputc('"', fp);
+    for (; *s; s++) {
+        if (*s == '"' || *s == '\\') {
+            fputc('\\', fp);
+            fputc(*s, fp);
+        } else if ((unsigned char)*s < 0x20) {
+            fprintf(fp, "\\u%04x", (unsigned char)*s);
+        } else {
+            fputc(*s, fp);
+        }
+    }
+    fputc('"', fp);
+}
+
+int profile_report(const char *json_path) {
+    FILE *fp;
+    double total_ms = 0.0;
+    int i;
+
+    /* Log, indenting nested phases */
+    for (i = 0; i < num_phases; i++) {
+        const profile_phase *ph = &phases[i];
+
+        if (ph->depth == 0 && ph->elapsed_ms > 0.0) {
+            total_ms += ph->elapsed_ms;
+        }
+
+        LOG_I("Startup: %*s%-24s %10.3f ms", ph->depth * 2, "",
+              ph->name, ph->elapsed_ms);
+    }
+    LOG_I("Startup: %-24s %10.3f ms", "total", total_ms);
+
+    if (!json_path || !json_path[0]) {
+        return 0;
+    }
+
+    fp = fopen(json_path, "w");
+    if (!fp) {
+        LOG_W("Startup profile: Failed to open %s for writing", json_path);
+        return -1;
+    }
+
+    fprintf(fp, "{\n  \"total_ms\": %.3f,\n  \"phases\": [", total_ms);
+    for (i = 0; i < num_phases; i++) {
+        const profile_phase *ph = &phases[i];
+
+        fprintf(fp, "%s\n    { \"name\": ", i ? "," : "");
+        write_json_string(fp, ph->name);
+        fprintf(fp, ", \"depth\": %d, \"start_ms\": %.3f, \"elapsed_ms\": %.3f }",
+                ph->depth, ph->start_ms, ph->elapsed_ms);
+    }
+    fprintf(fp, "\n  ]\n}\n");
+
+    fclose(fp);
+
+    LOG_I("Startup profile: Wrote %s", json_path);
+
+    return 0;
+}
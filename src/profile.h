@@ -0,0 +1,66 @@
+/* File: profile.h */
+#ifndef INCLUDED_PROFILE_H
+#define INCLUDED_PROFILE_H
+
+/*
+ * Maximum number of recorded phases
+ */
+#define PROFILE_MAX_PHASES 64
+
+/*
+ * Maximum nesting depth of phases
+ */
+#define PROFILE_MAX_DEPTH 8
+
+/*
+ * A single timed phase
+ */
+typedef struct {
+    const char *name;   /* Phase name (must be a static string) */
+    int depth;          /* Nesting depth, 0 for top-level phases */
+    double start_ms;    /* Start time, relative to the first phase */
+    double elapsed_ms;  /* Duration, or -1 while still running */
+} profile_phase;
+
+/*
+ * Get a high-resolution monotonic timestamp in milliseconds
+ * Only differences between two timestamps are meaningful
+ */
+double profile_now_ms(void);
+
+/*
+ * Start timing a phase
+ * Phases may nest; each call must be paired with profile_end()
+ * @param name: Phase name (must remain valid, normally a literal)
+ */
+void profile_begin(const char *name);
+
+/*
+ * Stop timing the innermost running phase
+ */
+void profile_end(void);
+
+/*
+ * Forget all recorded phases
+ */
+void profile_reset(void);
+
+/*
+ * Number of recorded phases
+ */
+int profile_phase_count(void);
+
+/*
+ * Get a recorded phase, in the order the phases were started
+ * @return: NULL if the index is out of range
+ */
+const profile_phase *profile_phase_get(int i);
+
+/*
+ * Write the recorded phases to the log, and optionally to a JSON file
+ * @param json_path: Path of the JSON file (NULL or "" for log output only)
+ * @return: 0 on success, -1 if the JSON file could not be written
+ */
+int profile_report(const char *json_path);
+
+#endif /* INCLUDED_PROFILE_H */
@@ -0,0 +1,288 @@
+/* File: replay.c */
+
+/*
+ * Keystroke recording and playback
+ *
+ * A recording holds the result of every request the game made for a key
+ * (see "Term_inkey()"), so that playing it back drives the game through
+ * exactly the same turns, however quickly it runs.  The format is a
+ * header followed by a stream of events:
+ *
+ *   k              A key (1-255) that was taken from the queue
+ *   0 'p' k        A key that was looked at but left in the queue
+ *   0 'n' count    "count" requests (1-255) that found no key ready
+ *   0 'r' n words  The RNG state, as "n" 32-bit little-endian words
+ */
+
+#include "replay.h"
+#include "logging.h"
+#include "profile.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPLAY_ESCAPE   0x00
+#define REPLAY_PEEK     'p'
+#define REPLAY_MISSES   'n'
+#define REPLAY_RNG      'r'
+
+#define REPLAY_HEADER_SIZE 5
+
+/* Recording */
+static FILE *record_fp = NULL;
+static int record_misses = 0;
+
+/* Playback */
+static unsigned char *play_buf = NULL;
+static long play_len = 0;
+static long play_pos = 0;
+static int play_misses = 0;
+
+static long key_count = 0;
+static double start_ms = 0.0;
+
+/*
+ * Write out any requests that found no key
+ */
+static void flush_misses(void) {
+    if (!record_misses) {
+        return;
+    }
+
+    fputc(REPLAY_ESCAPE, record_fp);
+    fputc(REPLAY_MISSES, record_fp);
+    fputc(record_misses, record_fp);
+
+    record_misses = 0;
+}
+
+int replay_record_start(const char *path) {
+    replay_close();
+
+    record_fp = fopen(path, "wb");
+    if (!record_fp) {
+        LOG_W("Replay: Failed to open %s for writing", path);
+        return -1;
+    }
+
+    fwrite(REPLAY_MAGIC, 1, 4, record_fp);
+    fputc(REPLAY_VERSION, record_fp);
+
+    key_count = 0;
+    start_ms = profile_now_ms();
+
+    LOG_I("Replay: Recording keys to %s", path);
+
+    return 0;
+}
+
+int replay_play_start(const char *path) {
+    FILE *fp;
+    long len;
+
+    replay_close();
+
+    fp = fopen(path, "rb");
+    if (!fp) {
+        LOG_W("Replay: Failed to open %s", path);
+        return -1;
+    }
+
+    fseek(fp, 0, SEEK_END);
+    len = ftell(fp);
+    fseek(fp, 0, SEEK_SET);
+
+    if (len < REPLAY_HEADER_SIZE) {
+        LOG_W("Replay: %s is not a replay file", path);
+        fclose(fp);
+        return -1;
+    }
+
+    play_buf = (unsigned char *)malloc((size_t)len);
+    if (!play_buf || fread(play_buf, 1, (size_t)len, fp) != (size_t)len ||
+        memcmp(play_buf, REPLAY_MAGIC, 4) || play_buf[4] != REPLAY_VERSION) {
+        LOG_W("Replay: %s is not a replay file", path);
+        free(play_buf);
+        play_buf = NULL;
+        fclose(fp);
+        return -1;
+    }
+
+    fclose(fp);
+
+    play_len = len;
+    play_pos = REPLAY_HEADER_SIZE;
+    play_misses = 0;
+
+    key_count = 0;
+    start_ms = profile_now_ms();
+
+    LOG_I("Replay: Playing back %s (%ld bytes)", path, len);
+
+    return 0;
+}
+
+int replay_recording(void) {
+    return record_fp != NULL;
+}
+
+int replay_playing(void) {
+    return play_buf != NULL;
+}
+
+void replay_record_key(char ch, int take) {
+    if (!record_fp) {
+        return;
+    }
+
+    /* No key -- counted, and written out later */
+    if (!ch) {
+        if (++record_misses == 255) {
+            flush_misses();
+        }
+        return;
+    }
+
+    flush_misses();
+
+    if (!take) {
+        fputc(REPLAY_ESCAPE, record_fp);
+        fputc(REPLAY_PEEK, record_fp);
+        fputc((unsigned char)ch, record_fp);
+        return;
+    }
+
+    fputc((unsigned char)ch, record_fp);
+    key_count++;
+
+    /* Keep the recording safe if the game crashes */
+    fflush(record_fp);
+}
+
+int replay_next(char *ch, int take) {
+    unsigned char c;
+
+    *ch = '\0';
+
+    if (!play_buf) {
+        return REPLAY_END;
+    }
+
+    /* The rest of a run of requests that found no key */
+    if (play_misses) {
+        play_misses--;
+        return REPLAY_NONE;
+    }
+
+    if (play_pos >= play_len) {
+        return REPLAY_END;
+    }
+
+    c = play_buf[play_pos];
+
+    /* A key taken from the queue (looking at it leaves it there) */
+    if (c != REPLAY_ESCAPE) {
+        *ch = (char)c;
+        if (take) {
+            play_pos++;
+            key_count++;
+        }
+        return REPLAY_KEY;
+    }
+
+    if (play_pos + 2 >= play_len) {
+        return REPLAY_END;
+    }
+
+    switch (play_buf[play_pos + 1]) {
+    case REPLAY_PEEK:
+        *ch = (char)play_buf[play_pos + 2];
+        play_pos += 3;
+        return REPLAY_KEY;
+
+    case REPLAY_MISSES:
+        play_misses = play_buf[play_pos + 2] - 1;
+        play_pos += 3;
+        return REPLAY_NONE;
+
+    default:
+        /* Out of step with the game */
+        LOG_W("Replay: Unexpected event at offset %ld", play_pos);
+        return REPLAY_END;
+    }
+}
+
+int replay_rng(unsigned long *words, int n) {
+    const unsigned char *p;
+    int i;
+
+    if (n > REPLAY_RNG_MAX) {
+        return -1;
+    }
+
+    if (record_fp) {
+        flush_misses();
+
+        fputc(REPLAY_ESCAPE, record_fp);
+        fputc(REPLAY_RNG, record_fp);
+        fputc(n, record_fp);
+
+        for (i = 0; i < n; i++) {
+            fputc((int)(words[i] & 0xFF), record_fp);
+            fputc((int)((words[i] >> 8) & 0xFF), record_fp);
+            fputc((int)((words[i] >> 16) & 0xFF), record_fp);
+            fputc((int)((words[i] >> 24) & 0xFF), record_fp);
+        }
+
+        fflush(record_fp);
+        return 0;
+    }
+
+    if (!play_buf) {
+        return 0;
+    }
+
+    /* The state must be the next event, and the right size */
+    if (play_misses || play_pos + 3 + 4 * n > play_len ||
+        play_buf[play_pos] != REPLAY_ESCAPE ||
+        play_buf[play_pos + 1] != REPLAY_RNG ||
+        play_buf[play_pos + 2] != n) {
+        LOG_W("Replay: No RNG state at offset %ld", play_pos);
+        return -1;
+    }
+
+    p = play_buf + play_pos + 3;
+    for (i = 0; i < n; i++, p += 4) {
+        words[i] = (unsigned long)p[0] | ((unsigned long)p[1] << 8) |
+                   ((unsigned long)p[2] << 16) | ((unsigned long)p[3] << 24);
+    }
+
+    play_pos += 3 + 4 * n;
+
+    return 0;
+}
+
+long replay_key_count(void) {
+    return key_count;
+}
+
+void replay_close(void) {
+    double elapsed = profile_now_ms() - start_ms;
+
+    if (record_fp) {
+        flush_misses();
+        fclose(record_fp);
+        record_fp = NULL;
+
+        LOG_I("Replay: Recorded %ld keys", key_count);
+    }
+
+    if (play_buf) {
+        free(play_buf);
+        play_buf = NULL;
+        play_len = play_pos = 0;
+        play_misses = 0;
+
+        LOG_I("Replay: Played back %ld keys in %.1f ms", key_count, elapsed);
+    }
+}
@@ -0,0 +1,86 @@
+/* File: replay.h */
+#ifndef INCLUDED_REPLAY_H
+#define INCLUDED_REPLAY_H
+
+/*
+ * Replay file signature and version
+ */
+#define REPLAY_MAGIC "SBRP"
+#define REPLAY_VERSION 1
+
+/*
+ * Maximum number of words in a recorded RNG state
+ */
+#define REPLAY_RNG_MAX 128
+
+/*
+ * Results of replay_next()
+ */
+#define REPLAY_KEY   0   /* A key was returned */
+#define REPLAY_NONE  1   /* No key was ready */
+#define REPLAY_END  -1   /* The replay is over (or does not match) */
+
+/*
+ * Start recording keypresses
+ * @param path: Replay file to write
+ * @return: 0 on success, -1 if the file could not be created
+ */
+int replay_record_start(const char *path);
+
+/*
+ * Start playing back a recording
+ * The whole file is read into memory, so playback costs no I/O.
+ * @param path: Replay file to read
+ * @return: 0 on success, -1 if the file could not be read or is not a
+ *          replay file
+ */
+int replay_play_start(const char *path);
+
+/*
+ * Check whether a recording is being made
+ * @return: 1 if so, 0 if not
+ */
+int replay_recording(void);
+
+/*
+ * Check whether a recording is being played back
+ * @return: 1 if so, 0 if not
+ */
+int replay_playing(void);
+
+/*
+ * Record the result of one request for a key
+ * @param ch: The key, or 0 if no key was ready
+ * @param take: Whether the key was removed from the queue
+ */
+void replay_record_key(char ch, int take);
+
+/*
+ * Play back the result of one request for a key
+ * @param ch: Where to put the key
+ * @param take: Whether the key is being removed from the queue (a key that
+ *              is only looked at is returned again by the next request)
+ * @return: REPLAY_KEY, REPLAY_NONE or REPLAY_END
+ */
+int replay_next(char *ch, int take);
+
+/*
+ * Record, or play back, the state of the random number generator
+ * @param words: The state (overwritten when playing back)
+ * @param n: Number of words (at most REPLAY_RNG_MAX)
+ * @return: 0 on success (or if neither recording nor playing), -1 if
+ *          the recording does not have a matching state at this point
+ */
+int replay_rng(unsigned long *words, int n);
+
+/*
+ * Number of keys recorded or played back so far
+ */
+long replay_key_count(void);
+
+/*
+ * Finish recording or playing back, and log a summary
+ */
+void replay_close(void);
+
+#endif /* INCLUDED_REPLAY_H */
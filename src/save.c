@@ -10,6 +10,16 @@
 
 #include "angband.h"
 
+#include "compress.h"
+#include "logging.h"
+#include "save_summary.h"
+#include "worker.h"
+
+#ifdef WINDOWS
+#include <windows.h>
+#include <io.h>
+#endif
+
 
 #ifdef FUTURE_SAVEFILES
 
@@ -613,24 +623,59 @@ static errr rd_savefile(void)
  * Some "local" parameters, used to help write savefiles
  */
 
-static FILE	*fff;		/* Current save "file" */
+static byte	*sf_out = NULL;		/* Savefile being built in memory */
+static u32b	sf_out_len = 0L;	/* Bytes in the savefile */
+static u32b	sf_out_size = 0L;	/* Allocated size of the savefile */
 
 static byte	xor_byte;	/* Simple encryption */
 
 static u32b	v_stamp = 0L;	/* A simple "checksum" on the actual values */
 static u32b	x_stamp = 0L;	/* A simple "checksum" on the encoded bytes */
 
+static byte	*sf_sect = NULL;	/* Section being collected for compression */
+static u32b	sf_sect_len = 0L;	/* Bytes in the section */
+static u32b	sf_sect_size = 0L;	/* Allocated size of the section */
+
+
+
+/*
+ * Double the size of a buffer holding "len" bytes
+ */
+static void sf_grow(byte **buf, u32b len, u32b *size)
+{
+	byte *old = *buf;
+
+	C_MAKE(*buf, *size * 2, byte);
+	(void)C_COPY(*buf, old, len, byte);
+	C_KILL(old, *size, byte);
+
+	*size *= 2;
+}
 
 
 /*
  * These functions place information into a savefile a byte at a time
+ *
+ * The savefile is built in memory, and written out in one go afterwards.
  */
 
 static void sf_put(byte v)
 {
-	/* Encode the value, write a character */
+	/* Collect a section for compression, unencoded */
+	if (sf_sect)
+	{
+		if (sf_sect_len == sf_sect_size) sf_grow(&sf_sect, sf_sect_len, &sf_sect_size);
+
+		sf_sect[sf_sect_len++] = v;
+		return;
+	}
+
+	/* Encode the value */
 	xor_byte ^= v;
-	(void)putc((int)xor_byte, fff);
+
+	/* Write a character */
+	if (sf_out_len == sf_out_size) sf_grow(&sf_out, sf_out_len, &sf_out_size);
+	sf_out[sf_out_len++] = xor_byte;
 
 	/* Maintain the checksum info */
 	v_stamp += v;
@@ -677,6 +722,93 @@ static void wr_string(cptr str)
 }
 
 
+/*
+ * Write the summary chunk (see "save_summary.c")
+ *
+ * This is stored as is, outside the encoded part of the savefile, so that
+ * "save_summary_probe()" can list characters without loading them.
+ */
+static void wr_summary(void)
+{
+	save_summary sum;
+	byte buf[SAVE_SUMMARY_SIZE];
+	size_t i, n;
+
+	/* Describe the character */
+	(void)WIPE(&sum, save_summary);
+	my_strcpy(sum.name, op_ptr->full_name, sizeof(sum.name));
+	my_strcpy(sum.race, p_name + rp_ptr->name, sizeof(sum.race));
+	my_strcpy(sum.pclass, c_name + cp_ptr->name, sizeof(sum.pclass));
+	sum.race_idx = p_ptr->prace;
+	sum.class_idx = p_ptr->pclass;
+	sum.is_dead = p_ptr->is_dead ? 1 : 0;
+	sum.lev = p_ptr->lev;
+	sum.depth = p_ptr->depth;
+	sum.turn = turn;
+
+	n = save_summary_encode(&sum, buf);
+
+	/* Append the chunk, bypassing the encoding and the checksums */
+	for (i = 0; i < n; i++)
+	{
+		if (sf_out_len == sf_out_size) sf_grow(&sf_out, sf_out_len, &sf_out_size);
+		sf_out[sf_out_len++] = buf[i];
+	}
+}
+
+
+/*
+ * Start collecting a section of the savefile to be compressed.
+ *
+ * Everything written until "wr_compressed_end()" is kept in memory,
+ * and then written as a "u32b" uncompressed size, a "u32b" compressed
+ * size, and the compressed bytes (see "compress.c").
+ */
+static void wr_compressed_begin(void)
+{
+	sf_sect_size = 0x10000L;
+	sf_sect_len = 0L;
+	C_MAKE(sf_sect, sf_sect_size, byte);
+}
+
+
+/*
+ * Compress and write the section started by "wr_compressed_begin()"
+ */
+static bool wr_compressed_end(void)
+{
+	byte *raw = sf_sect;
+
+	byte *comp;
+	u32b comp_size, comp_len, i;
+
+
+	/* Stop collecting */
+	sf_sect = NULL;
+
+	/* Compress the section */
+	comp_size = (u32b)compress_bound(sf_sect_len);
+	C_MAKE(comp, comp_size, byte);
+	comp_len = (u32b)compress_block(raw, sf_sect_len, comp, comp_size);
+
+	/* Write it */
+	if (comp_len)
+	{
+		wr_u32b(sf_sect_len);
+		wr_u32b(comp_len);
+
+		for (i = 0; i < comp_len; i++) sf_put(comp[i]);
+	}
+
+	/* Free the buffers */
+	C_KILL(comp, comp_size, byte);
+	C_KILL(raw, sf_sect_size, byte);
+
+	/* Result */
+	return (comp_len ? TRUE : FALSE);
+}
+
+
 /*
  * These functions write info in larger logical records
  */
@@ -872,10 +1004,13 @@ static void wr_store(const store_type *st_ptr)
  */
 static errr wr_randomizer(void)
 {
-	int i;
+	int i, s;
 
-	/* Zero */
-	wr_u16b(0);
+	/* The main stream goes first */
+	int old_stream = Rand_stream_set(RAND_STREAM_MAIN);
+
+	/* Algorithm (zero in older savefiles) */
+	wr_u16b(Rand_mode);
 
 	/* Place */
 	wr_u16b(Rand_place);
@@ -886,6 +1021,23 @@ static errr wr_randomizer(void)
 		wr_u32b(Rand_state[i]);
 	}
 
+	/* Number of streams */
+	wr_byte(RAND_STREAM_MAX);
+
+	/* The other streams */
+	for (s = 1; s < RAND_STREAM_MAX; s++)
+	{
+		wr_u16b(Rand_stream_place[s]);
+
+		for (i = 0; i < RAND_DEG; i++)
+		{
+			wr_u32b(Rand_stream_state[s][i]);
+		}
+	}
+
+	/* Restore the stream */
+	(void)Rand_stream_set(old_stream);
+
 	/* Success */
 	return (0);
 }
@@ -1216,11 +1368,6 @@ static void wr_dungeon(void)
 {
 	int i, y, x;
 
-	byte tmp8u;
-
-	byte count;
-	byte prev_char;
-
 
 	/*** Basic info ***/
 
@@ -1235,83 +1382,27 @@ static void wr_dungeon(void)
 	wr_u16b(0);
 
 
-	/*** Simple "Run-Length-Encoding" of cave ***/
-
-	/* Note that this will induce two wasted bytes */
-	count = 0;
-	prev_char = 0;
+	/*** Cave (the whole dungeon is compressed) ***/
 
-	/* Dump the cave */
+	/* Dump the "info" */
 	for (y = 0; y < DUNGEON_HGT; y++)
 	{
 		for (x = 0; x < DUNGEON_WID; x++)
 		{
 			/* Extract the important cave_info flags */
-			tmp8u = (cave_info[y][x] & (IMPORTANT_FLAGS));
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				wr_byte((byte)count);
-				wr_byte((byte)prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			}
-
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
+			wr_byte((byte)(cave_info[y][x] & (IMPORTANT_FLAGS)));
 		}
 	}
 
-	/* Flush the data (if any) */
-	if (count)
-	{
-		wr_byte((byte)count);
-		wr_byte((byte)prev_char);
-	}
-
-
-	/*** Simple "Run-Length-Encoding" of cave ***/
-
-	/* Note that this will induce two wasted bytes */
-	count = 0;
-	prev_char = 0;
-
-	/* Dump the cave */
+	/* Dump the "feat" */
 	for (y = 0; y < DUNGEON_HGT; y++)
 	{
 		for (x = 0; x < DUNGEON_WID; x++)
 		{
-			/* Extract a byte */
-			tmp8u = cave_feat[y][x];
-
-			/* If the run is broken, or too full, flush it */
-			if ((tmp8u != prev_char) || (count == MAX_UCHAR))
-			{
-				wr_byte((byte)count);
-				wr_byte((byte)prev_char);
-				prev_char = tmp8u;
-				count = 1;
-			}
-
-			/* Continue the run */
-			else
-			{
-				count++;
-			}
+			wr_byte(cave_feat[y][x]);
 		}
 	}
 
-	/* Flush the data (if any) */
-	if (count)
-	{
-		wr_byte((byte)count);
-		wr_byte((byte)prev_char);
-	}
-
 
 	/*** Compact ***/
 
@@ -1382,16 +1473,24 @@ static bool wr_savefile_new(void)
 
 	/*** Actually write the file ***/
 
+	/* Start with an empty savefile */
+	sf_out_size = 0x20000L;
+	sf_out_len = 0L;
+	C_MAKE(sf_out, sf_out_size, byte);
+
 	/* Dump the file header */
 	xor_byte = 0;
-	wr_byte(VERSION_MAJOR);
+	wr_byte(SAVEFILE_MAJOR);
 	xor_byte = 0;
-	wr_byte(VERSION_MINOR);
+	wr_byte(SAVEFILE_MINOR);
 	xor_byte = 0;
-	wr_byte(VERSION_PATCH);
+	wr_byte(SAVEFILE_PATCH);
 	xor_byte = 0;
 	wr_byte(VERSION_EXTRA);
 
+	/* Dump the summary */
+	wr_summary();
+
 
 	/* Reset the checksum */
 	v_stamp = 0L;
@@ -1543,8 +1642,10 @@ static bool wr_savefile_new(void)
 	/* Player is not dead, write the dungeon */
 	if (!p_ptr->is_dead)
 	{
-		/* Dump the dungeon */
+		/* Dump the dungeon, compressed */
+		wr_compressed_begin();
 		wr_dungeon();
+		if (!wr_compressed_end()) return FALSE;
 
 		/* Dump the ghost */
 		wr_ghost();
@@ -1558,80 +1659,104 @@ static bool wr_savefile_new(void)
 	wr_u32b(x_stamp);
 
 
-	/* Error in save */
-	if (ferror(fff) || (fflush(fff) == EOF)) return FALSE;
-
 	/* Successful save */
 	return TRUE;
 }
 
 
 /*
- * Medium level player saver
+ * Forget the savefile built by "wr_savefile_new()"
+ */
+static void sf_out_free(void)
+{
+	if (sf_out) C_KILL(sf_out, sf_out_size, byte);
+	sf_out_len = sf_out_size = 0L;
+}
+
+
+/*
+ * Write a savefile built in memory to a file, and make sure it has
+ * reached the disk.  The caller handles permissions.
  *
- * XXX XXX XXX Angband 2.8.0 will use "fd" instead of "fff" if possible
+ * This is also run on a worker thread, so it must not touch the game.
  */
-static bool save_player_aux(cptr name)
+static bool sf_write_file(cptr name, const byte *buf, u32b len)
 {
-	bool ok = FALSE;
+	FILE *fff;
 
 	int fd;
 
 	int mode = 0644;
 
-
-	/* No file yet */
-	fff = NULL;
+	bool ok = FALSE;
 
 
 	/* File type is "SAVE" */
 	FILE_TYPE(FILE_TYPE_SAVE);
 
-
-	/* Grab permissions */
-	safe_setuid_grab();
-
 	/* Create the savefile */
 	fd = fd_make(name, mode);
 
-	/* Drop permissions */
-	safe_setuid_drop();
+	/* File is not okay */
+	if (fd < 0) return (FALSE);
 
-	/* File is okay */
-	if (fd >= 0)
+	/* Close the "fd" */
+	fd_close(fd);
+
+	/* Open the savefile */
+	fff = my_fopen(name, "wb");
+
+	/* Successful open */
+	if (fff)
 	{
-		/* Close the "fd" */
-		fd_close(fd);
+		/* Write the savefile */
+		if (fwrite(buf, 1, len, fff) == len) ok = TRUE;
 
-		/* Grab permissions */
-		safe_setuid_grab();
+		/* Flush it to the disk */
+		if (fflush(fff) == EOF) ok = FALSE;
 
-		/* Open the savefile */
-		fff = my_fopen(name, "wb");
+#if defined(WINDOWS)
+		if (_commit(_fileno(fff))) ok = FALSE;
+#elif defined(SET_UID)
+		if (fsync(fileno(fff))) ok = FALSE;
+#endif
 
-		/* Drop permissions */
-		safe_setuid_drop();
+		/* Attempt to close it */
+		if (my_fclose(fff)) ok = FALSE;
+	}
 
-		/* Successful open */
-		if (fff)
-		{
-			/* Write the savefile */
-			if (wr_savefile_new()) ok = TRUE;
+	/* Remove "broken" files */
+	if (!ok) fd_kill(name);
 
-			/* Attempt to close it */
-			if (my_fclose(fff)) ok = FALSE;
-		}
+	/* Result */
+	return (ok);
+}
 
+
+/*
+ * Medium level player saver
+ */
+static bool save_player_aux(cptr name)
+{
+	bool ok = FALSE;
+
+
+	/* Build the savefile */
+	if (wr_savefile_new())
+	{
 		/* Grab permissions */
 		safe_setuid_grab();
 
-		/* Remove "broken" files */
-		if (!ok) fd_kill(name);
+		/* Write the savefile */
+		ok = sf_write_file(name, sf_out, sf_out_len);
 
 		/* Drop permissions */
 		safe_setuid_drop();
 	}
 
+	/* Forget the savefile */
+	sf_out_free();
+
 
 	/* Failure */
 	if (!ok) return (FALSE);
@@ -1655,6 +1780,10 @@ bool save_player(void)
 	char safe[1024];
 
 
+	/* Finish any background save first */
+	if (!save_player_wait()) msg_print("Autosave failed!");
+
+
 #ifdef SET_UID
 
 # ifdef SECURE
@@ -1762,6 +1891,190 @@ bool save_player(void)
 
 
 
+/*
+ * A savefile built in memory, being written by a worker thread
+ */
+typedef struct save_job save_job;
+
+struct save_job
+{
+	byte *buf;			/* Encoded savefile */
+	u32b len;			/* Bytes in the savefile */
+	u32b size;			/* Allocated size of "buf" */
+
+	char temp[1024];	/* File to write */
+	char name[1024];	/* File to replace with it */
+
+	bool ok;			/* The save worked */
+};
+
+/*
+ * The background save in progress (if any)
+ */
+static save_job *save_pending = NULL;
+
+/*
+ * The thread writing it (NULL if it was written in the foreground)
+ */
+static worker *save_worker = NULL;
+
+
+/*
+ * Replace one file with another in a single step, so a crash leaves
+ * either the old or the new file, never neither.
+ */
+static bool fd_replace(cptr file, cptr what)
+{
+	char buf[1024];
+	char aux[1024];
+
+	/* Hack -- Try to parse the path */
+	if (path_parse(buf, 1024, file)) return (FALSE);
+
+	/* Hack -- Try to parse the path */
+	if (path_parse(aux, 1024, what)) return (FALSE);
+
+#ifdef WINDOWS
+	/* Plain "rename()" will not replace an existing file */
+	return (MoveFileExA(buf, aux, MOVEFILE_REPLACE_EXISTING |
+	                    MOVEFILE_WRITE_THROUGH) ? TRUE : FALSE);
+#else
+	return (rename(buf, aux) ? FALSE : TRUE);
+#endif
+}
+
+
+/*
+ * Write a background save (run by the worker thread)
+ */
+static void save_job_write(void *arg)
+{
+	save_job *job = (save_job*)arg;
+
+	/* Write and sync the new savefile */
+	job->ok = sf_write_file(job->temp, job->buf, job->len);
+
+	/* Put it in place of the old one */
+	if (job->ok) job->ok = fd_replace(job->temp, job->name);
+
+	/* Oops */
+	if (!job->ok) LOG_E("Autosave: Failed to write %s", job->name);
+}
+
+
+/*
+ * Permissions are shared by all threads, so a game that has to juggle
+ * them for its savefiles must save in the foreground.
+ */
+static bool save_background_okay(void)
+{
+#ifdef SET_UID
+
+# ifdef SECURE
+
+	/* Saving needs "games" permissions */
+	return (FALSE);
+
+# endif /* SECURE */
+
+# ifdef SAFE_SETUID
+
+	/* Installed setgid */
+	if (player_egid != (int)getgid()) return (FALSE);
+
+# endif /* SAFE_SETUID */
+
+#endif /* SET_UID */
+
+	/* Okay */
+	return (TRUE);
+}
+
+
+/*
+ * Wait for a background save to finish
+ *
+ * Returns FALSE if it failed.
+ */
+bool save_player_wait(void)
+{
+	bool ok;
+
+	/* Nothing to wait for */
+	if (!save_pending) return (TRUE);
+
+	/* Wait for the thread */
+	worker_wait(save_worker);
+	save_worker = NULL;
+
+	/* Result */
+	ok = save_pending->ok;
+
+	/* Free the job */
+	C_KILL(save_pending->buf, save_pending->size, byte);
+	KILL(save_pending, save_job);
+
+	return (ok);
+}
+
+
+/*
+ * Save the player without stopping the game
+ *
+ * The savefile is built in memory right away, so it is a consistent
+ * snapshot of the game, and is then written, synced to the disk, and
+ * renamed over the old savefile by a worker thread.
+ */
+bool autosave_player(void)
+{
+	save_job *job;
+
+
+	/* Finish the previous autosave */
+	if (!save_player_wait()) msg_print("Autosave failed!");
+
+	/* Save in the foreground */
+	if (!save_background_okay()) return (save_player());
+
+	/* Build the savefile */
+	if (!wr_savefile_new())
+	{
+		sf_out_free();
+		return (FALSE);
+	}
+
+	/* Hand the savefile over to a job */
+	MAKE(job, save_job);
+	job->buf = sf_out;
+	job->len = sf_out_len;
+	job->size = sf_out_size;
+	sf_out = NULL;
+	sf_out_free();
+
+	/* New savefile */
+	strcpy(job->name, savefile);
+	strcpy(job->temp, savefile);
+	strcat(job->temp, ".new");
+
+	/* Start writing it */
+	save_pending = job;
+	save_worker = worker_start(save_job_write, job);
+
+	/* No threads -- write it now */
+	if (!save_worker) save_job_write(job);
+
+	/* Successful save (as far as we know) */
+	character_saved = TRUE;
+
+	/* Hack -- Pretend the character was loaded */
+	character_loaded = TRUE;
+
+	/* Success */
+	return (TRUE);
+}
+
+
+
 /*
  * Attempt to Load a "savefile"
  *
@@ -1997,9 +2310,9 @@ bool load_player(void)
 	if (!err)
 	{
 		/* Give a conversion warning */
-		if ((version_major != sf_major) ||
-		    (version_minor != sf_minor) ||
-		    (version_patch != sf_patch))
+		if ((SAVEFILE_MAJOR != sf_major) ||
+		    (SAVEFILE_MINOR != sf_minor) ||
+		    (SAVEFILE_PATCH != sf_patch))
 		{
 			/* Message */
 			msg_format("Converted a %d.%d.%d savefile.",
@@ -0,0 +1,144 @@
+/* File: save_summary.c */
+#include "save_summary.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Bytes covered by the checksum (everything but the prefix and checksum) */
+#define SUMMARY_BODY (SAVE_SUMMARY_SIZE - 2 - 4)
+
+/* Savefile version as a single comparable number */
+#define VERSION_KEY(X, Y, Z) (((long)(X) << 16) | ((long)(Y) << 8) | (long)(Z))
+
+/* Checksum of the body of a chunk */
+static unsigned long summary_checksum(const unsigned char *body) {
+    unsigned long sum = 0x5A5A5A5AUL;
+    int i;
+
+    for (i = 0; i < SUMMARY_BODY; i++) {
+        sum = ((sum << 5) | (sum >> 27)) & 0xFFFFFFFFUL;
+        sum ^= body[i];
+    }
+
+    return sum;
+}
+
+static unsigned char *put_u16(unsigned char *p, unsigned long v) {
+    p[0] = (unsigned char)(v & 0xFF);
+    p[1] = (unsigned char)((v >> 8) & 0xFF);
+    return p + 2;
+}
+
+static unsigned char *put_u32(unsigned char *p, unsigned long v) {
+    p = put_u16(p, v & 0xFFFF);
+    return put_u16(p, (v >> 16) & 0xFFFF);
+}
+
+static unsigned long get_u16(const unsigned char *p) {
+    return (unsigned long)p[0] | ((unsigned long)p[1] << 8);
+}
+
+static unsigned long get_u32(const unsigned char *p) {
+    return get_u16(p) | (get_u16(p + 2) << 16);
+}
+
+/* Copy a string into a fixed-size field, truncating and padding it */
+static unsigned char *put_str(unsigned char *p, const char *s, size_t n) {
+    size_t len = strlen(s);
+
+    if (len > n - 1) {
+        len = n - 1;
+    }
+    memset(p, 0, n);
+    memcpy(p, s, len);
+
+    return p + n;
+}
+
+static const unsigned char *get_str(const unsigned char *p, char *s, size_t n) {
+    memcpy(s, p, n);
+    s[n - 1] = '\0';
+
+    return p + n;
+}
+
+size_t save_summary_encode(save_summary *sum, unsigned char *buf) {
+    unsigned char *p = buf;
+    unsigned char *body;
+
+    p = put_u16(p, SAVE_SUMMARY_SIZE - 2);
+
+    body = p;
+    p = put_str(p, sum->name, sizeof(sum->name));
+    p = put_str(p, sum->race, sizeof(sum->race));
+    p = put_str(p, sum->pclass, sizeof(sum->pclass));
+    *p++ = sum->race_idx;
+    *p++ = sum->class_idx;
+    *p++ = sum->is_dead;
+    p = put_u16(p, (unsigned short)sum->lev);
+    p = put_u16(p, (unsigned short)sum->depth);
+    p = put_u32(p, (unsigned long)sum->turn);
+
+    sum->checksum = summary_checksum(body);
+    p = put_u32(p, sum->checksum);
+
+    return (size_t)(p - buf);
+}
+
+int save_summary_decode(const unsigned char *buf, size_t len, save_summary *sum) {
+    const unsigned char *p = buf;
+    const unsigned char *body;
+
+    /* Must hold at least the fields we know about */
+    if (len < SAVE_SUMMARY_SIZE || get_u16(p) < SAVE_SUMMARY_SIZE - 2) {
+        return -1;
+    }
+    p += 2;
+
+    body = p;
+    p = get_str(p, sum->name, sizeof(sum->name));
+    p = get_str(p, sum->race, sizeof(sum->race));
+    p = get_str(p, sum->pclass, sizeof(sum->pclass));
+    sum->race_idx = *p++;
+    sum->class_idx = *p++;
+    sum->is_dead = *p++;
+    sum->lev = (short)get_u16(p);
+    p += 2;
+    sum->depth = (short)get_u16(p);
+    p += 2;
+    sum->turn = (long)get_u32(p);
+    p += 4;
+    sum->checksum = get_u32(p);
+
+    if (sum->checksum != summary_checksum(body)) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int save_summary_probe(const char *path, save_summary *sum) {
+    unsigned char buf[SAVE_SUMMARY_OFFSET + SAVE_SUMMARY_SIZE];
+    size_t len;
+    FILE *fp;
+
+    fp = fopen(path, "rb");
+    if (!fp) {
+        return -1;
+    }
+
+    len = fread(buf, 1, sizeof(buf), fp);
+    fclose(fp);
+
+    if (len < SAVE_SUMMARY_OFFSET) {
+        return -1;
+    }
+
+    /* Older savefiles have no summary */
+    if (VERSION_KEY(buf[0], buf[1], buf[2]) <
+        VERSION_KEY(SAVE_SUMMARY_MAJOR, SAVE_SUMMARY_MINOR, SAVE_SUMMARY_PATCH)) {
+        return -1;
+    }
+
+    return save_summary_decode(buf + SAVE_SUMMARY_OFFSET,
+                               len - SAVE_SUMMARY_OFFSET, sum);
+}
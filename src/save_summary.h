@@ -0,0 +1,71 @@
+/* File: save_summary.h */
+#ifndef INCLUDED_SAVE_SUMMARY_H
+#define INCLUDED_SAVE_SUMMARY_H
+
+#include <stddef.h>
+
+/*
+ * First savefile version with a summary chunk
+ */
+#define SAVE_SUMMARY_MAJOR 0
+#define SAVE_SUMMARY_MINOR 2
+#define SAVE_SUMMARY_PATCH 4
+
+/*
+ * Offset of the summary chunk, right after the four version bytes
+ */
+#define SAVE_SUMMARY_OFFSET 4
+
+/*
+ * Size of an encoded summary chunk, including its two-byte length prefix
+ */
+#define SAVE_SUMMARY_SIZE 81
+
+/*
+ * What a character-select screen needs to know about a savefile
+ * All strings are NUL-terminated (and truncated to fit)
+ */
+typedef struct {
+    char name[32];          /* Character name */
+    char race[16];          /* Race name */
+    char pclass[16];        /* Class name */
+    unsigned char race_idx; /* Index into p_info */
+    unsigned char class_idx;/* Index into c_info */
+    unsigned char is_dead;  /* Character is dead */
+    short lev;              /* Character level */
+    short depth;            /* Current depth, in levels */
+    long turn;              /* Game turn */
+    unsigned long checksum; /* Checksum of the other fields (set on encode) */
+} save_summary;
+
+/*
+ * Encode a summary chunk
+ * The chunk is stored as plain little-endian bytes (not encrypted like
+ * the rest of the savefile), so it can be read without parsing the file.
+ * @param sum: Summary to encode; its checksum field is filled in
+ * @param buf: Output buffer of at least SAVE_SUMMARY_SIZE bytes
+ * @return: Number of bytes written (SAVE_SUMMARY_SIZE)
+ */
+size_t save_summary_encode(save_summary *sum, unsigned char *buf);
+
+/*
+ * Decode a summary chunk
+ * Longer chunks (written by later versions) are accepted, and the extra
+ * bytes ignored.
+ * @param buf: Encoded chunk, starting at its length prefix
+ * @param len: Number of bytes available in buf
+ * @param sum: Decoded summary
+ * @return: 0 on success, -1 if the chunk is short or fails its checksum
+ */
+int save_summary_decode(const unsigned char *buf, size_t len, save_summary *sum);
+
+/*
+ * Read the summary of a savefile, without loading the rest of it
+ * @param path: Savefile to probe
+ * @param sum: Decoded summary
+ * @return: 0 on success, -1 if the file cannot be read, predates the
+ *          summary chunk, or the chunk is corrupt
+ */
+int save_summary_probe(const char *path, save_summary *sum);
+
+#endif /* INCLUDED_SAVE_SUMMARY_H */
@@ -0,0 +1,222 @@
+/* File: sckclient.c */
+
+/*
+ * A simple client for the socket frontend (see main-sck.c).
+ *
+ * Connects to a game started with "-msck", draws its frames on this
+ * terminal with ANSI escape sequences, and sends the keys typed here
+ * back to the game.  Press Ctrl-] to disconnect, leaving the game
+ * running for the next client.
+ *
+ * Keys may also be piped in, to drive a game from a script; the client
+ * then runs until the game closes the connection.
+ */
+
+#include "main-sck.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <unistd.h>
+#include <termios.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/select.h>
+
+#define CLIENT_QUIT_KEY 0x1D
+
+/*
+ * ANSI colours for the sixteen Angband colours, as in main-gcu.c
+ */
+static const char *ansi_color[16] = {
+    "0;30", "0;37", "0;37", "1;31", "0;31", "0;32", "0;34", "0;33",
+    "1;30", "1;37", "0;35", "1;33", "1;35", "1;32", "1;34", "0;33"
+};
+
+static struct termios norm_termios;
+static int raw_mode = 0;
+
+/* Incoming messages, kept until they are complete */
+static unsigned char in_buf[65536];
+static size_t in_len = 0;
+
+/* Cursor, drawn at the end of each frame */
+static int curs_y = 0, curs_x = 0;
+
+static long frames = 0;
+static long bytes = 0;
+
+static void raw_on(void) {
+    struct termios t;
+
+    if (!isatty(0) || tcgetattr(0, &norm_termios)) {
+        return;
+    }
+
+    t = norm_termios;
+    t.c_lflag &= ~(ICANON | ECHO | ISIG);
+    t.c_iflag &= ~(IXON | ICRNL);
+    t.c_cc[VMIN] = 1;
+    t.c_cc[VTIME] = 0;
+
+    if (!tcsetattr(0, TCSAFLUSH, &t)) {
+        raw_mode = 1;
+    }
+}
+
+static void raw_off(void) {
+    if (raw_mode) {
+        tcsetattr(0, TCSAFLUSH, &norm_termios);
+        raw_mode = 0;
+    }
+}
+
+/*
+ * Size of the message at the start of the buffer, or 0 if it is not
+ * all there yet
+ */
+static size_t message_size(const unsigned char *p, size_t len) {
+    switch (p[0]) {
+    case SCK_HELLO: return (len >= 4) ? 4 : 0;
+    case SCK_TEXT: return (len >= 5 && len >= 5u + p[3]) ? 5u + p[3] : 0;
+    case SCK_WIPE: return (len >= 4) ? 4 : 0;
+    case SCK_CURS: return (len >= 3) ? 3 : 0;
+    case SCK_SHAPE: return (len >= 2) ? 2 : 0;
+    default: return 1;
+    }
+}
+
+/*
+ * Draw one message
+ */
+static void draw_message(const unsigned char *p) {
+    switch (p[0]) {
+    case SCK_HELLO:
+        if (p[1] != SCK_VERSION) {
+            fprintf(stderr, "Unknown protocol version %d\n", p[1]);
+            raw_off();
+            exit(2);
+        }
+        printf("\033[0m\033[2J");
+        break;
+
+    case SCK_TEXT:
+        printf("\033[%d;%dH\033[%sm%.*s", p[1] + 1, p[2] + 1,
+               ansi_color[p[4] & 0x0F], p[3], (const char *)p + 5);
+        break;
+
+    case SCK_WIPE:
+        printf("\033[%d;%dH\033[0m%*s", p[1] + 1, p[2] + 1, p[3], "");
+        break;
+
+    case SCK_CURS:
+        curs_y = p[1];
+        curs_x = p[2];
+        break;
+
+    case SCK_SHAPE:
+        printf(p[1] ? "\033[?25h" : "\033[?25l");
+        break;
+
+    case SCK_CLEAR:
+        printf("\033[0m\033[2J");
+        break;
+
+    case SCK_BELL:
+        printf("\007");
+        break;
+
+    case SCK_FRAME:
+        printf("\033[%d;%dH", curs_y + 1, curs_x + 1);
+        fflush(stdout);
+        frames++;
+        break;
+    }
+}
+
+int main(int argc, char *argv[]) {
+    const char *path = (argc > 1) ? argv[1] : SCK_PATH;
+    struct sockaddr_un addr;
+    int fd, keys_open = 1;
+
+    if (strlen(path) >= sizeof(addr.sun_path)) {
+        fprintf(stderr, "%s: socket name too long\n", argv[0]);
+        return 2;
+    }
+
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    memset(&addr, 0, sizeof(addr));
+    addr.sun_family = AF_UNIX;
+    strcpy(addr.sun_path, path);
+
+    if (fd < 0 || connect(fd, (struct sockaddr *)&addr, sizeof(addr)) < 0) {
+        fprintf(stderr, "%s: cannot connect to %s\n", argv[0], path);
+        return 2;
+    }
+
+    raw_on();
+
+    while (1) {
+        fd_set fds;
+        ssize_t n;
+        size_t pos, size;
+
+        FD_ZERO(&fds);
+        FD_SET(fd, &fds);
+        if (keys_open) {
+            FD_SET(0, &fds);
+        }
+
+        if (select(fd + 1, &fds, NULL, NULL, NULL) < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            break;
+        }
+
+        /* Keys for the game */
+        if (keys_open && FD_ISSET(0, &fds)) {
+            char keys[64];
+
+            n = read(0, keys, sizeof(keys));
+            if (n <= 0) {
+                keys_open = 0;
+            } else if (raw_mode && memchr(keys, CLIENT_QUIT_KEY, (size_t)n)) {
+                break;
+            } else if (send(fd, keys, (size_t)n, 0) < 0) {
+                break;
+            }
+        }
+
+        /* Frames from the game */
+        if (FD_ISSET(fd, &fds)) {
+            n = recv(fd, in_buf + in_len, sizeof(in_buf) - in_len, 0);
+            if (n <= 0) {
+                break;
+            }
+
+            in_len += (size_t)n;
+            bytes += n;
+
+            for (pos = 0; pos < in_len; pos += size) {
+                size = message_size(in_buf + pos, in_len - pos);
+                if (!size) {
+                    break;
+                }
+                draw_message(in_buf + pos);
+            }
+
+            memmove(in_buf, in_buf + pos, in_len - pos);
+            in_len -= pos;
+        }
+    }
+
+    raw_off();
+    printf("\033[0m\033[?25h\n");
+
+    fprintf(stderr, "%ld frames, %ld bytes (%.1f bytes per frame)\n",
+            frames, bytes, frames ? (double)bytes / frames : 0.0);
+
+    close(fd);
+    return 0;
+}
@@ -0,0 +1,231 @@
+/* File: snapshot.c */
+
+/*
+ * Purpose: in-memory copies of the game state
+ *
+ * A snapshot is one contiguous buffer holding every piece of mutable game
+ * state -- the player, the inventory, the level, the stores, the monster
+ * memory and the random number generator.  Restoring it is a handful of
+ * "memcpy()" calls, so benchmarks can replay an expensive situation many
+ * times, and tests can branch from one state, without going through the
+ * savefile code.
+ *
+ * Snapshots only make sense within the session that took them, since the
+ * arrays are copied as they are, pointers and all.
+ */
+
+#include "angband.h"
+
+
+/*
+ * A piece of the game state
+ */
+typedef struct snapshot_region snapshot_region;
+
+struct snapshot_region
+{
+	vptr addr;			/* Where it lives */
+	u32b size;			/* Size in bytes */
+};
+
+
+/*
+ * Maximum number of regions
+ */
+#define SNAPSHOT_REGIONS_MAX	(64 + 2 * MAX_STORES)
+
+
+/*
+ * The regions, in buffer order
+ */
+static snapshot_region snapshot_regions[SNAPSHOT_REGIONS_MAX];
+static int snapshot_region_num = 0;
+
+
+/*
+ * Add a region
+ */
+static void snapshot_add(vptr addr, u32b size)
+{
+	snapshot_region *s_ptr;
+
+	/* Paranoia */
+	if (snapshot_region_num >= SNAPSHOT_REGIONS_MAX) quit("Too many snapshot regions!");
+
+	s_ptr = &snapshot_regions[snapshot_region_num++];
+
+	s_ptr->addr = addr;
+	s_ptr->size = size;
+}
+
+
+/*
+ * Add a global variable
+ */
+#define SNAPSHOT_VAR(V) \
+	snapshot_add((vptr)&(V), (u32b)sizeof(V))
+
+/*
+ * Add "N" entries of a global array
+ */
+#define SNAPSHOT_ARRAY(A, N) \
+	snapshot_add((vptr)(A), (u32b)((N) * sizeof((A)[0])))
+
+
+/*
+ * List the regions of the game state
+ *
+ * The arrays are allocated once by "init_angband()", so this only needs
+ * doing once, but it is cheap enough to do on every call.
+ */
+static u32b snapshot_prepare(void)
+{
+	int i;
+	u32b size = 0L;
+
+	snapshot_region_num = 0;
+
+	/* The player */
+	snapshot_add((vptr)p_ptr, (u32b)sizeof(player_type));
+	SNAPSHOT_ARRAY(inventory, INVEN_TOTAL);
+
+	/* The level */
+	SNAPSHOT_ARRAY(cave_info, DUNGEON_HGT);
+	SNAPSHOT_ARRAY(cave_feat, DUNGEON_HGT);
+	SNAPSHOT_ARRAY(cave_o_idx, DUNGEON_HGT);
+	SNAPSHOT_ARRAY(cave_m_idx, DUNGEON_HGT);
+#ifdef MONSTER_FLOW
+	SNAPSHOT_ARRAY(cave_cost, DUNGEON_HGT);
+	SNAPSHOT_ARRAY(cave_when, DUNGEON_HGT);
+#endif /* MONSTER_FLOW */
+	SNAPSHOT_ARRAY(view_g, VIEW_MAX);
+	SNAPSHOT_VAR(view_n);
+	SNAPSHOT_ARRAY(o_list, z_info->o_max);
+	SNAPSHOT_ARRAY(m_list, z_info->m_max);
+	SNAPSHOT_VAR(o_max);
+	SNAPSHOT_VAR(o_cnt);
+	SNAPSHOT_VAR(m_max);
+	SNAPSHOT_VAR(m_cnt);
+	SNAPSHOT_VAR(num_repro);
+	SNAPSHOT_VAR(object_level);
+	SNAPSHOT_VAR(monster_level);
+	SNAPSHOT_VAR(feeling);
+	SNAPSHOT_VAR(rating);
+	SNAPSHOT_VAR(good_item_flag);
+
+	/* The time */
+	SNAPSHOT_VAR(turn);
+	SNAPSHOT_VAR(old_turn);
+
+	/* The stores */
+	SNAPSHOT_ARRAY(store, MAX_STORES);
+	for (i = 0; i < MAX_STORES; i++)
+	{
+		SNAPSHOT_ARRAY(store[i].stock, store[i].stock_size);
+		SNAPSHOT_ARRAY(store[i].table, store[i].table_size);
+	}
+
+	/* Monster populations and memory, artifacts, object knowledge */
+	SNAPSHOT_ARRAY(r_info, z_info->r_max);
+	SNAPSHOT_ARRAY(l_list, z_info->r_max);
+	SNAPSHOT_ARRAY(a_info, z_info->a_max);
+	SNAPSHOT_ARRAY(k_info, z_info->k_max);
+	SNAPSHOT_ARRAY(q_list, MAX_Q_IDX);
+
+	/* The random number generator */
+	SNAPSHOT_VAR(Rand_quick);
+	SNAPSHOT_VAR(Rand_value);
+	SNAPSHOT_VAR(Rand_place);
+	SNAPSHOT_VAR(Rand_mode);
+	SNAPSHOT_ARRAY(Rand_state, RAND_DEG);
+	SNAPSHOT_VAR(Rand_stream);
+	SNAPSHOT_ARRAY(Rand_stream_place, RAND_STREAM_MAX);
+	SNAPSHOT_ARRAY(Rand_stream_state, RAND_STREAM_MAX);
+
+	/* Total size */
+	for (i = 0; i < snapshot_region_num; i++) size += snapshot_regions[i].size;
+
+	return (size);
+}
+
+
+/*
+ * Copy the current game state into a new snapshot
+ */
+snapshot_type *snapshot_take(void)
+{
+	snapshot_type *s_ptr;
+	byte *p;
+	int i;
+
+	MAKE(s_ptr, snapshot_type);
+
+	s_ptr->size = snapshot_prepare();
+	C_MAKE(s_ptr->buf, s_ptr->size, byte);
+
+	/* Copy each region */
+	p = s_ptr->buf;
+	for (i = 0; i < snapshot_region_num; i++)
+	{
+		(void)C_COPY(p, snapshot_regions[i].addr, snapshot_regions[i].size, byte);
+		p += snapshot_regions[i].size;
+	}
+
+	return (s_ptr);
+}
+
+
+/*
+ * Put the game state back the way it was when a snapshot was taken
+ *
+ * Returns FALSE (and changes nothing) if the snapshot does not fit the
+ * current game, which should only happen if it came from another game.
+ */
+bool snapshot_restore(const snapshot_type *s_ptr)
+{
+	const byte *p;
+	int i;
+
+	/* Paranoia */
+	if (snapshot_prepare() != s_ptr->size) return (FALSE);
+
+	/* Copy each region back */
+	p = s_ptr->buf;
+	for (i = 0; i < snapshot_region_num; i++)
+	{
+		(void)C_COPY(snapshot_regions[i].addr, p, snapshot_regions[i].size, byte);
+		p += snapshot_regions[i].size;
+	}
+
+	/* Recalculate everything */
+	p_ptr->update |= (PU_BONUS | PU_HP | PU_MANA | PU_SPELLS | PU_TORCH);
+	p_ptr->update |= (PU_FORGET_VIEW | PU_UPDATE_VIEW | PU_DISTANCE);
+
+	/* Redraw everything */
+	p_ptr->redraw |= (PR_BASIC | PR_EXTRA | PR_MAP);
+	p_ptr->window |= (PW_INVEN | PW_EQUIP | PW_PLAYER_0 | PW_PLAYER_1);
+	p_ptr->window |= (PW_OVERHEAD | PW_MONSTER | PW_OBJECT);
+
+	return (TRUE);
+}
+
+
+/*
+ * Check whether two snapshots hold exactly the same game state
+ */
+bool snapshot_same(const snapshot_type *s_ptr, const snapshot_type *t_ptr)
+{
+	if (s_ptr->size != t_ptr->size) return (FALSE);
+
+	return (memcmp(s_ptr->buf, t_ptr->buf, s_ptr->size) == 0);
+}
+
+
+/*
+ * Forget a snapshot
+ */
+void snapshot_free(snapshot_type *s_ptr)
+{
+	C_KILL(s_ptr->buf, s_ptr->size, byte);
+	KILL(s_ptr, snapshot_type);
+}
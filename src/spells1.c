@@ -10,6 +10,8 @@
 
 #include "angband.h"
 
+#include "replay.h"
+
 
 
 
@@ -4238,6 +4240,207 @@ static bool project_p(int who, int r, int y, int x, int dam, int typ)
 
 
 
+/*
+ * Grids waiting to be animated (see "project()")
+ *
+ * Rather than drawing each step of a projection and pausing at once,
+ * "project()" queues the grids it would draw, each tagged with the frame
+ * in which it appears, and "anim_play()" then shows the frames.  While a
+ * batch is open (see "anim_batch_begin()"), the grids of several
+ * projections are collected, and played back together, so that a volley
+ * of bolts takes as long to watch as a single bolt.
+ *
+ * A "transient" grid (the head of a bolt) is erased at the end of its
+ * frame, while the others (beams and blasts) stay until the animation
+ * is over.
+ */
+static byte anim_y[ANIM_GRIDS_MAX];
+static byte anim_x[ANIM_GRIDS_MAX];
+static byte anim_a[ANIM_GRIDS_MAX];
+static char anim_c[ANIM_GRIDS_MAX];
+static byte anim_frame[ANIM_GRIDS_MAX];
+static bool anim_transient[ANIM_GRIDS_MAX];
+
+/* Number of queued grids */
+static int anim_n = 0;
+
+/* Number of frames (some may be empty, to keep the pace of a bolt) */
+static int anim_frames = 0;
+
+/* Nesting depth of "anim_batch_begin()" */
+static int anim_batch = 0;
+
+
+/*
+ * Check whether a new keypress has arrived since "old" keys were queued
+ */
+static int anim_keys(void)
+{
+	/* Check for events, without waiting */
+	Term_xtra(TERM_XTRA_EVENT, FALSE);
+
+	/* Count the keys in the queue */
+	return ((Term->key_head + Term->key_size - Term->key_tail) %
+	        Term->key_size);
+}
+
+
+/*
+ * Show (and forget) the queued animation
+ *
+ * Nothing is shown while a recording is played back, or when there is no
+ * delay between frames (since nobody could see it), and the rest of the
+ * animation is skipped as soon as a key is pressed.
+ */
+static void anim_play(void)
+{
+	int msec = op_ptr->delay_factor * op_ptr->delay_factor;
+
+	int i, f, keys = 0;
+
+	bool skip = (replay_playing() || !msec || !anim_n);
+
+
+	/* Note the keys already waiting */
+	if (!skip) keys = anim_keys();
+
+	/* Show each frame */
+	for (f = 0; !skip && (f < anim_frames); f++)
+	{
+		int cy = -1, cx = -1;
+
+		bool transient = FALSE;
+
+		/* Draw the grids of this frame, bolts last */
+		for (i = 0; i < anim_n; i++)
+		{
+			if (anim_frame[i] != f) continue;
+			if (anim_transient[i]) continue;
+
+			print_rel(anim_c[i], anim_a[i], anim_y[i], anim_x[i]);
+			cy = anim_y[i];
+			cx = anim_x[i];
+		}
+
+		for (i = 0; i < anim_n; i++)
+		{
+			if (anim_frame[i] != f) continue;
+			if (!anim_transient[i]) continue;
+
+			print_rel(anim_c[i], anim_a[i], anim_y[i], anim_x[i]);
+			cy = anim_y[i];
+			cx = anim_x[i];
+
+			transient = TRUE;
+		}
+
+		/* Hack -- center the cursor */
+		if (cy >= 0) move_cursor_relative(cy, cx);
+
+		/* Show the frame */
+		if (fresh_before) Term_fresh();
+		Term_xtra(TERM_XTRA_DELAY, msec);
+
+		/* Erase the bolts, but not the grids drawn under them */
+		if (transient)
+		{
+			for (i = 0; i < anim_n; i++)
+			{
+				if (anim_frame[i] != f) continue;
+
+				if (anim_transient[i])
+				{
+					lite_spot(anim_y[i], anim_x[i]);
+				}
+			}
+
+			for (i = 0; i < anim_n; i++)
+			{
+				if (anim_frame[i] != f) continue;
+
+				if (!anim_transient[i])
+				{
+					print_rel(anim_c[i], anim_a[i], anim_y[i], anim_x[i]);
+				}
+			}
+		}
+
+		/* Skip the rest when a key is pressed */
+		if (anim_keys() > keys) break;
+	}
+
+	/* Erase everything drawn above */
+	if (!skip)
+	{
+		for (i = 0; i < anim_n; i++)
+		{
+			lite_spot(anim_y[i], anim_x[i]);
+		}
+
+		/* Flush the erasing */
+		if (fresh_before) Term_fresh();
+	}
+
+	/* Forget the animation */
+	anim_n = 0;
+	anim_frames = 0;
+}
+
+
+/*
+ * Queue a grid to be drawn in a given frame of the animation
+ */
+static void anim_grid(int y, int x, u16b p, int frame, bool transient)
+{
+	/* Show what we have, to make room */
+	if (anim_n == ANIM_GRIDS_MAX) anim_play();
+
+	/* Paranoia */
+	if (frame >= 255) return;
+
+	anim_y[anim_n] = y;
+	anim_x[anim_n] = x;
+	anim_a[anim_n] = PICT_A(p);
+	anim_c[anim_n] = PICT_C(p);
+	anim_frame[anim_n] = frame;
+	anim_transient[anim_n] = transient;
+	anim_n++;
+
+	/* Count the frames */
+	if (anim_frames <= frame) anim_frames = frame + 1;
+}
+
+
+/*
+ * Note that a frame is needed, even if nothing is drawn in it
+ */
+static void anim_pause(int frame)
+{
+	/* Count the frames */
+	if ((frame < 255) && (anim_frames <= frame)) anim_frames = frame + 1;
+}
+
+
+/*
+ * Start collecting the animations of several projections, which will be
+ * played back together by "anim_batch_end()"
+ */
+void anim_batch_begin(void)
+{
+	anim_batch++;
+}
+
+
+/*
+ * Play back the projections collected since "anim_batch_begin()"
+ */
+void anim_batch_end(void)
+{
+	if (anim_batch && !--anim_batch) anim_play();
+}
+
+
+
 /*
  * Generic "beam"/"bolt"/"ball" projection routine.
  *
@@ -4390,7 +4593,8 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 	int y1, x1;
 	int y2, x2;
 
-	int msec = op_ptr->delay_factor * op_ptr->delay_factor;
+	/* Animation frame of the next step */
+	int frame = 0;
 
 	/* Assume the player sees nothing */
 	bool notice = FALSE;
@@ -4521,49 +4725,28 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 			/* Only do visuals if the player can "see" the bolt */
 			if (panel_contains(y, x) && player_has_los_bold(y, x))
 			{
-				u16b p;
-
-				byte a;
-				char c;
-
-				/* Obtain the bolt pict */
-				p = bolt_pict(oy, ox, y, x, typ);
-
-				/* Extract attr/char */
-				a = PICT_A(p);
-				c = PICT_C(p);
-
-				/* Visual effects */
-				print_rel(c, a, y, x);
-				move_cursor_relative(y, x);
-				if (fresh_before) Term_fresh();
-				Term_xtra(TERM_XTRA_DELAY, msec);
-				lite_spot(y, x);
-				if (fresh_before) Term_fresh();
+				/* Visual effects -- the bolt moves on */
+				anim_grid(y, x, bolt_pict(oy, ox, y, x, typ), frame, TRUE);
 
 				/* Display "beam" grids */
 				if (flg & (PROJECT_BEAM))
 				{
-					/* Obtain the explosion pict */
-					p = bolt_pict(y, x, y, x, typ);
-
-					/* Extract attr/char */
-					a = PICT_A(p);
-					c = PICT_C(p);
-
-					/* Visual effects */
-					print_rel(c, a, y, x);
+					/* Visual effects -- the beam stays */
+					anim_grid(y, x, bolt_pict(y, x, y, x, typ), frame, FALSE);
 				}
 
 				/* Hack -- Activate delay */
 				visual = TRUE;
+
+				/* Next frame */
+				frame++;
 			}
 
 			/* Hack -- delay anyway for consistency */
 			else if (visual)
 			{
 				/* Delay for consistency */
-				Term_xtra(TERM_XTRA_DELAY, msec);
+				anim_pause(frame++);
 			}
 		}
 	}
@@ -4616,7 +4799,13 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 
 
 	/* Speed -- ignore "non-explosions" */
-	if (!grids) return (FALSE);
+	if (!grids)
+	{
+		/* Show the bolt anyway */
+		if (!anim_batch) anim_play();
+
+		return (FALSE);
+	}
 
 
 	/* Display the "blast area" if requested */
@@ -4635,62 +4824,23 @@ bool project(int who, int rad, int y, int x, int dam, int typ, int flg)
 				/* Only do visuals if the player can "see" the blast */
 				if (panel_contains(y, x) && player_has_los_bold(y, x))
 				{
-					u16b p;
-
-					byte a;
-					char c;
-
 					drawn = TRUE;
 
-					/* Obtain the explosion pict */
-					p = bolt_pict(y, x, y, x, typ);
-
-					/* Extract attr/char */
-					a = PICT_A(p);
-					c = PICT_C(p);
-
 					/* Visual effects -- Display */
-					print_rel(c, a, y, x);
+					anim_grid(y, x, bolt_pict(y, x, y, x, typ), frame, FALSE);
 				}
 			}
 
-			/* Hack -- center the cursor */
-			move_cursor_relative(y2, x2);
-
-			/* Flush each "radius" seperately */
-			if (fresh_before) Term_fresh();
-
-			/* Delay (efficiently) */
-			if (visual || drawn)
-			{
-				Term_xtra(TERM_XTRA_DELAY, msec);
-			}
+			/* Each "radius" is a separate frame */
+			if (visual || drawn) anim_pause(frame++);
 		}
+	}
 
-		/* Flush the erasing */
-		if (drawn)
-		{
-			/* Erase the explosion drawn above */
-			for (i = 0; i < grids; i++)
-			{
-				/* Extract the location */
-				y = gy[i];
-				x = gx[i];
-
-				/* Hack -- Erase if needed */
-				if (panel_contains(y, x) && player_has_los_bold(y, x))
-				{
-					lite_spot(y, x);
-				}
-			}
-
-			/* Hack -- center the cursor */
-			move_cursor_relative(y2, x2);
+	/* Show the projection, unless it is part of a batch */
+	if (!anim_batch) anim_play();
 
-			/* Flush the explosion */
-			if (fresh_before) Term_fresh();
-		}
-	}
+	/* Hack -- only the animation was wanted (see "fire_volley()") */
+	if (flg & (PROJECT_ANIM)) return (FALSE);
 
 
 	/* Check features */
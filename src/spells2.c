@@ -3368,6 +3368,79 @@ bool fire_bolt_or_beam(int prob, int typ, int dir, int dam)
 	}
 }
 
+/*
+ * Scatter "num" bolts (or balls of radius "rad") around (ly, lx), at
+ * most "ld * dev / 20" grids away, for "fire_blast()" and "fire_barrage()"
+ *
+ * The targets and damage of every bolt are picked first, and the whole
+ * volley is animated at once, before any of it has any effect, so that
+ * the messages about what it hit come after the animation, in order.
+ */
+static bool fire_volley(int typ, int rad, int ly, int lx, int ld,
+                        int dd, int ds, int num, int dev)
+{
+	int *vy, *vx, *vdam;
+	int i;
+
+	int flg = PROJECT_THRU | PROJECT_STOP | PROJECT_KILL | PROJECT_GRID;
+
+	/* Assume okay */
+	bool result = TRUE;
+
+
+	/* Nothing to fire */
+	if (num <= 0) return (result);
+
+	/* Room for the bolts */
+	C_MAKE(vy, num, int);
+	C_MAKE(vx, num, int);
+	C_MAKE(vdam, num, int);
+
+	/* Aim */
+	for (i = 0; i < num; i++)
+	{
+		while (1)
+		{
+			/* Get targets for some bolts */
+			vy[i] = rand_spread(ly, ld * dev / 20);
+			vx[i] = rand_spread(lx, ld * dev / 20);
+
+			if (distance(ly, lx, vy[i], vx[i]) <= ld * dev / 20) break;
+		}
+
+		/* Roll the damage */
+		vdam[i] = damroll(dd, ds);
+	}
+
+	/* Animate the whole volley at once */
+	anim_batch_begin();
+
+	for (i = 0; i < num; i++)
+	{
+		(void)project(-1, rad, vy[i], vx[i], 0, typ, flg | PROJECT_ANIM);
+	}
+
+	/* Show the volley */
+	anim_batch_end();
+
+	/* Then let it hit */
+	for (i = 0; i < num; i++)
+	{
+		/* Analyze the "dir" and the "target". */
+		if (!project(-1, rad, vy[i], vx[i], vdam[i], typ, flg | PROJECT_HIDE))
+		{
+			result = FALSE;
+		}
+	}
+
+	C_KILL(vdam, num, int);
+	C_KILL(vx, num, int);
+	C_KILL(vy, num, int);
+
+	return (result);
+}
+
+
 /*
  * Why the fuck isn't this working!?!
  *								-ccc
@@ -3392,15 +3465,9 @@ bool fire_blast(int typ, int dir, int dd, int ds, int num, int dev)
 {
 	int ly, lx, ld;
 	int ty, tx, y, x, dist;
-	int i;
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
-	int flg = PROJECT_THRU | PROJECT_STOP | PROJECT_KILL | PROJECT_GRID;
-
-	/* Assume okay */
-	bool result = TRUE;
-
 	/* Use the given direction */
 	ly = ty = py + 20 * ddy[dir];
 	lx = tx = px + 20 * ddx[dir];
@@ -3439,40 +3506,16 @@ bool fire_blast(int typ, int dir, int dd, int ds, int num, int dev)
 	}
 
 	/* Blast */
-	for (i = 0; i < num; i++)
-	{
-		while (1)
-		{
-			/* Get targets for some bolts */
-			y = rand_spread(ly, ld * dev / 20);
-			x = rand_spread(lx, ld * dev / 20);
-
-			if (distance(ly, lx, y, x) <= ld * dev / 20) break;
-		}
-
-		/* Analyze the "dir" and the "target". */
-		if (!project(-1, 0, y, x, damroll(dd, ds), typ, flg))
-		{
-			result = FALSE;
-		}
-	}
-
-	return (result);
+	return (fire_volley(typ, 0, ly, lx, ld, dd, ds, num, dev));
 }
 
 bool fire_barrage(int typ, int dir, int dd, int ds, int num, int dev)
 {
 	int ly, lx, ld;
 	int ty, tx, y, x, dist;
-	int i;
 	int py = p_ptr->py;
 	int px = p_ptr->px;
 
-	int flg = PROJECT_THRU | PROJECT_STOP | PROJECT_KILL | PROJECT_GRID;
-
-	/* Assume okay */
-	bool result = TRUE;
-
 	/* Use the given direction */
 	ly = ty = py + 20 * ddy[dir];
 	lx = tx = px + 20 * ddx[dir];
@@ -3511,25 +3554,7 @@ bool fire_barrage(int typ, int dir, int dd, int ds, int num, int dev)
 	}
 
 	/* Blast */
-	for (i = 0; i < num; i++)
-	{
-		while (1)
-		{
-			/* Get targets for some bolts */
-			y = rand_spread(ly, ld * dev / 20);
-			x = rand_spread(lx, ld * dev / 20);
-
-			if (distance(ly, lx, y, x) <= ld * dev / 20) break;
-		}
-
-		/* Analyze the "dir" and the "target". */
-		if (!project(-1, 3, y, x, damroll(dd, ds), typ, flg))
-		{
-			result = FALSE;
-		}
-	}
-
-	return (result);
+	return (fire_volley(typ, 3, ly, lx, ld, dd, ds, num, dev));
 }
 
 
@@ -3449,13 +3449,16 @@ void do_cmd_store(void)
  */
 void store_shuffle(int which)
 {
-	int i, j;
+	int i, j, old_stream;
 
 
 	/* Ignore home */
 	if (which == STORE_HOME) return;
 
 
+	/* Use the store stream */
+	old_stream = Rand_stream_set(RAND_STREAM_STORE);
+
 	/* Save the store index */
 	store_num = which;
 
@@ -3493,6 +3496,9 @@ void store_shuffle(int which)
 		/* Clear the "fixed price" flag */
 		o_ptr->ident &= ~(IDENT_FIXED);
 	}
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
 
 
@@ -3501,7 +3507,7 @@ void store_shuffle(int which)
  */
 void store_maint(int which)
 {
-	int j;
+	int j, old_stream;
 
 	int old_rating = rating;
 
@@ -3510,6 +3516,9 @@ void store_maint(int which)
 	if (which == STORE_HOME) return;
 
 
+	/* Use the store stream */
+	old_stream = Rand_stream_set(RAND_STREAM_STORE);
+
 	/* Save the store index */
 	store_num = which;
 
@@ -3583,6 +3592,9 @@ void store_maint(int which)
 
 	/* Hack -- Restore the rating */
 	rating = old_rating;
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
 
 
@@ -3591,9 +3603,12 @@ void store_maint(int which)
  */
 void store_init(int which)
 {
-	int k;
+	int k, old_stream;
 
 
+	/* Use the store stream */
+	old_stream = Rand_stream_set(RAND_STREAM_STORE);
+
 	/* Save the store index */
 	store_num = which;
 
@@ -3622,4 +3637,7 @@ void store_init(int which)
 	{
 		object_wipe(&st_ptr->stock[k]);
 	}
+
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
 }
@@ -2112,8 +2112,8 @@ cptr option_text[OPT_MAX] =
 	"auto_more",				/* OPT_auto_more */
 	"smart_monsters",			/* OPT_smart_monsters */
 	"smart_packs",				/* OPT_smart_packs */
-	NULL,						/* xxx */
-	NULL,						/* xxx */
+	"autosave_level",			/* OPT_autosave_level */
+	"persistent_levels",		/* OPT_persistent_levels */
 	NULL,						/* xxx */
 	NULL,						/* xxx */
 	NULL,						/* xxx */
@@ -2376,8 +2376,8 @@ cptr option_desc[OPT_MAX] =
 	"Automatically clear '-more-' prompts",		/* OPT_auto_more */
 	"Monsters behave more intelligently",		/* OPT_smart_monsters */
 	"Monsters act smarter in groups (v.slow)",	/* OPT_smart_packs */
-	NULL,										/* xxx */
-	NULL,										/* xxx */
+	"Autosave when entering a new level",		/* OPT_autosave_level */
+	"Remember recently visited dungeon levels",	/* OPT_persistent_levels */
 	NULL,										/* xxx */
 	NULL,										/* xxx */
 	NULL,										/* xxx */
@@ -2640,8 +2640,8 @@ const bool option_norm[OPT_MAX] =
 	FALSE,		/* OPT_auto_more */
 	TRUE,		/* OPT_smart_monsters */
 	TRUE,		/* OPT_smart_packs */
-	FALSE,		/* xxx */
-	FALSE,		/* xxx */
+	TRUE,		/* OPT_autosave_level */
+	FALSE,		/* OPT_persistent_levels */
 	FALSE,		/* xxx */
 	FALSE,		/* xxx */
 	FALSE,		/* xxx */
@@ -2903,7 +2903,7 @@ const byte option_page[OPT_PAGE_MAX][OPT_PAGE_PER] =
 		OPT_easy_alter,
 		OPT_easy_floor,
 		OPT_show_piles,
-		255,
+		OPT_persistent_levels,
 		255
 	},
 
@@ -2919,6 +2919,7 @@ const byte option_page[OPT_PAGE_MAX][OPT_PAGE_PER] =
 		OPT_fresh_before,
 		OPT_fresh_after,
 		OPT_compress_savefile,
+		OPT_autosave_level,
 		OPT_hilite_player,
 		OPT_view_yellow_lite,
 		OPT_view_bright_lite,
@@ -2929,7 +2930,6 @@ const byte option_page[OPT_PAGE_MAX][OPT_PAGE_PER] =
 		OPT_scroll_target,
 		255,
 		255,
-		255,
 	},
 
 	/*** Birth ***/
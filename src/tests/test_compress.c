@@ -0,0 +1,79 @@
+/* File: src/tests/test_compress.c
+ * Tests for the savefile block compressor (compress.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../compress.h"
+#include <string.h>
+
+#define TEST_BLOCK_SIZE 13068
+
+static unsigned char raw[TEST_BLOCK_SIZE];
+static unsigned char packed[TEST_BLOCK_SIZE + TEST_BLOCK_SIZE / 255 + 16];
+static unsigned char unpacked[TEST_BLOCK_SIZE];
+
+/* Compress and decompress raw[0..len), checking the round trip */
+static size_t round_trip(size_t len) {
+    size_t packed_len = compress_block(raw, len, packed, compress_bound(len));
+
+    TEST_ASSERT_TRUE(packed_len > 0);
+    TEST_ASSERT_TRUE(packed_len <= compress_bound(len));
+
+    TEST_ASSERT_EQUAL_INT((long)len, decompress_block(packed, packed_len, unpacked, len));
+    TEST_ASSERT_EQUAL_MEMORY(raw, unpacked, len);
+
+    return packed_len;
+}
+
+/* Test cave-like data (long runs and repeated rows) shrinks a lot */
+void test_compress_round_trip_repetitive(void) {
+    size_t i;
+
+    for (i = 0; i < TEST_BLOCK_SIZE; i++) {
+        raw[i] = (unsigned char)(((i / 37) % 3) ? 1 : 32 + (i % 198) / 20);
+    }
+
+    TEST_ASSERT_TRUE(round_trip(TEST_BLOCK_SIZE) < TEST_BLOCK_SIZE / 10);
+
+    /* Tiny and empty blocks work too */
+    round_trip(0);
+    round_trip(1);
+    round_trip(5);
+}
+
+/* Test data that does not compress stays within the bound */
+void test_compress_round_trip_incompressible(void) {
+    unsigned long seed = 12345;
+    size_t i;
+
+    for (i = 0; i < TEST_BLOCK_SIZE; i++) {
+        seed = seed * 1103515245UL + 12345UL;
+        raw[i] = (unsigned char)(seed >> 16);
+    }
+
+    round_trip(TEST_BLOCK_SIZE);
+
+    /* Too small an output buffer is reported, not overrun */
+    TEST_ASSERT_EQUAL_INT(0, (int)compress_block(raw, TEST_BLOCK_SIZE, packed, TEST_BLOCK_SIZE / 2));
+}
+
+/* Test corrupt or truncated input is rejected */
+void test_compress_rejects_corrupt_input(void) {
+    size_t packed_len;
+
+    memset(raw, 'x', 1000);
+    packed_len = compress_block(raw, 1000, packed, sizeof(packed));
+    TEST_ASSERT_TRUE(packed_len > 3);
+
+    /* Output too small for the data */
+    TEST_ASSERT_EQUAL_INT(-1, decompress_block(packed, packed_len, unpacked, 999));
+
+    /* Truncated in the middle of a match */
+    TEST_ASSERT_EQUAL_INT(-1, decompress_block(packed, 3, unpacked, 1000));
+
+    /* Match offset pointing before the start of the output */
+    packed[0] = 0x00;
+    packed[1] = 0x10;
+    packed[2] = 0x00;
+    TEST_ASSERT_EQUAL_INT(-1, decompress_block(packed, 3, unpacked, 1000));
+}
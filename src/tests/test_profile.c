@@ -0,0 +1,93 @@
+/* File: src/tests/test_profile.c
+ * Tests for the startup phase profiler (profile.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../profile.h"
+#include "test_helpers.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Test nested phases keep their order, depth, and timings */
+void test_profile_nested_phases(void) {
+    const profile_phase *outer;
+    const profile_phase *inner;
+
+    profile_reset();
+
+    profile_begin("outer");
+    profile_begin("inner");
+    profile_end();
+    profile_end();
+
+    TEST_ASSERT_EQUAL_INT(2, profile_phase_count());
+
+    outer = profile_phase_get(0);
+    inner = profile_phase_get(1);
+    TEST_ASSERT_NOT_NULL(outer);
+    TEST_ASSERT_NOT_NULL(inner);
+
+    TEST_ASSERT_EQUAL_STRING("outer", outer->name);
+    TEST_ASSERT_EQUAL_STRING("inner", inner->name);
+    TEST_ASSERT_EQUAL_INT(0, outer->depth);
+    TEST_ASSERT_EQUAL_INT(1, inner->depth);
+
+    /* Both finished, and the outer phase encloses the inner one */
+    TEST_ASSERT_TRUE(inner->elapsed_ms >= 0.0);
+    TEST_ASSERT_TRUE(outer->elapsed_ms >= inner->elapsed_ms);
+    TEST_ASSERT_TRUE(inner->start_ms >= outer->start_ms);
+
+    TEST_ASSERT_NULL(profile_phase_get(2));
+}
+
+/* Test unbalanced and overflowing calls are harmless */
+void test_profile_overflow_and_unbalanced(void) {
+    int i;
+
+    profile_reset();
+
+    /* Ending with nothing running is ignored */
+    profile_end();
+    TEST_ASSERT_EQUAL_INT(0, profile_phase_count());
+
+    /* Phases beyond the table are dropped, not written out of bounds */
+    for (i = 0; i < PROFILE_MAX_PHASES + 10; i++) {
+        profile_begin("phase");
+        profile_end();
+    }
+    TEST_ASSERT_EQUAL_INT(PROFILE_MAX_PHASES, profile_phase_count());
+
+    profile_reset();
+    TEST_ASSERT_EQUAL_INT(0, profile_phase_count());
+}
+
+/* Test the JSON report contains every phase */
+void test_profile_json_report(void) {
+    test_file_t tf = test_create_temp_file("test_profile");
+    char buffer[4096];
+    size_t len;
+    FILE *f;
+
+    TEST_ASSERT_TRUE(tf.created);
+
+    profile_reset();
+    profile_begin("init_angband");
+    profile_begin("init_r_info");
+    profile_end();
+    profile_end();
+
+    TEST_ASSERT_EQUAL_INT(0, profile_report(tf.path));
+
+    f = fopen(tf.path, "r");
+    TEST_ASSERT_NOT_NULL(f);
+    len = fread(buffer, 1, sizeof(buffer) - 1, f);
+    buffer[len] = '\0';
+    fclose(f);
+
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"total_ms\""));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"name\": \"init_angband\", \"depth\": 0"));
+    TEST_ASSERT_NOT_NULL(strstr(buffer, "\"name\": \"init_r_info\", \"depth\": 1"));
+
+    test_cleanup_temp_file(&tf);
+    profile_reset();
+}
@@ -0,0 +1,109 @@
+/* File: src/tests/test_replay.c
+ * Tests for keystroke recording and playback (replay.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../replay.h"
+#include "test_helpers.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Test keys, peeks and long runs of empty polls come back in order */
+void test_replay_round_trip(void) {
+    test_file_t tf = test_create_temp_file("test_replay");
+    char ch;
+    int i;
+
+    TEST_ASSERT_TRUE(tf.created);
+
+    TEST_ASSERT_EQUAL_INT(0, replay_record_start(tf.path));
+    TEST_ASSERT_TRUE(replay_recording());
+    replay_record_key('a', 1);
+    for (i = 0; i < 300; i++) replay_record_key(0, 1);
+    replay_record_key('\033', 0);
+    replay_record_key('\033', 1);
+    replay_record_key((char)0xE0, 1);
+    TEST_ASSERT_EQUAL_INT(3, (int)replay_key_count());
+    replay_close();
+    TEST_ASSERT_FALSE(replay_recording());
+
+    TEST_ASSERT_EQUAL_INT(0, replay_play_start(tf.path));
+    TEST_ASSERT_TRUE(replay_playing());
+
+    /* Looking at a key leaves it for the next request */
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 0));
+    TEST_ASSERT_EQUAL_INT('a', ch);
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 1));
+    TEST_ASSERT_EQUAL_INT('a', ch);
+
+    for (i = 0; i < 300; i++) {
+        TEST_ASSERT_EQUAL_INT(REPLAY_NONE, replay_next(&ch, 1));
+    }
+
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 0));
+    TEST_ASSERT_EQUAL_INT('\033', ch);
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 1));
+    TEST_ASSERT_EQUAL_INT('\033', ch);
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 1));
+    TEST_ASSERT_EQUAL_INT((char)0xE0, ch);
+    TEST_ASSERT_EQUAL_INT(REPLAY_END, replay_next(&ch, 1));
+    TEST_ASSERT_EQUAL_INT(3, (int)replay_key_count());
+
+    replay_close();
+    TEST_ASSERT_FALSE(replay_playing());
+
+    test_cleanup_temp_file(&tf);
+}
+
+/* Test the RNG state is restored, and only where it was recorded */
+void test_replay_rng_state(void) {
+    test_file_t tf = test_create_temp_file("test_replay");
+    unsigned long words[3] = { 0xDEADBEEFUL, 7, 0x01020304UL };
+    unsigned long back[3] = { 0, 0, 0 };
+    char ch;
+
+    TEST_ASSERT_TRUE(tf.created);
+
+    /* Nothing to do when not recording */
+    TEST_ASSERT_EQUAL_INT(0, replay_rng(back, 3));
+
+    TEST_ASSERT_EQUAL_INT(0, replay_record_start(tf.path));
+    replay_record_key('x', 1);
+    TEST_ASSERT_EQUAL_INT(0, replay_rng(words, 3));
+    replay_close();
+
+    /* Out of step: the key has not been used yet */
+    TEST_ASSERT_EQUAL_INT(0, replay_play_start(tf.path));
+    TEST_ASSERT_EQUAL_INT(-1, replay_rng(back, 3));
+    replay_close();
+
+    TEST_ASSERT_EQUAL_INT(0, replay_play_start(tf.path));
+    TEST_ASSERT_EQUAL_INT(REPLAY_KEY, replay_next(&ch, 1));
+    TEST_ASSERT_EQUAL_INT(-1, replay_rng(back, 2));
+    TEST_ASSERT_EQUAL_INT(0, replay_rng(back, 3));
+    TEST_ASSERT_TRUE(memcmp(words, back, sizeof(words)) == 0);
+    TEST_ASSERT_EQUAL_INT(REPLAY_END, replay_next(&ch, 1));
+    replay_close();
+
+    test_cleanup_temp_file(&tf);
+}
+
+/* Test missing files and files of the wrong kind are refused */
+void test_replay_rejects_bad_file(void) {
+    test_file_t tf = test_create_temp_file("test_replay");
+    FILE *f;
+
+    TEST_ASSERT_TRUE(tf.created);
+
+    f = fopen(tf.path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fputs("not a replay", f);
+    fclose(f);
+
+    TEST_ASSERT_EQUAL_INT(-1, replay_play_start(tf.path));
+    TEST_ASSERT_FALSE(replay_playing());
+
+    test_cleanup_temp_file(&tf);
+
+    TEST_ASSERT_EQUAL_INT(-1, replay_play_start(tf.path));
+}
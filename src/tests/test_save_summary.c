@@ -0,0 +1,107 @@
+/* File: src/tests/test_save_summary.c
+ * Tests for the savefile summary chunk (save_summary.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../save_summary.h"
+#include "test_helpers.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Fill in a typical summary */
+static void make_summary(save_summary *sum) {
+    memset(sum, 0, sizeof(*sum));
+    strcpy(sum->name, "Bryan");
+    strcpy(sum->race, "Steam-Mecha");
+    strcpy(sum->pclass, "Steam Engineer");
+    sum->race_idx = 7;
+    sum->class_idx = 3;
+    sum->lev = 30;
+    sum->depth = 12;
+    sum->turn = 1234567L;
+}
+
+/* Test a summary survives encoding and decoding */
+void test_save_summary_round_trip(void) {
+    unsigned char buf[SAVE_SUMMARY_SIZE + 8];
+    save_summary in, out;
+
+    make_summary(&in);
+
+    TEST_ASSERT_EQUAL_INT(SAVE_SUMMARY_SIZE, (int)save_summary_encode(&in, buf));
+    TEST_ASSERT_EQUAL_INT(0, save_summary_decode(buf, SAVE_SUMMARY_SIZE, &out));
+
+    TEST_ASSERT_EQUAL_STRING("Bryan", out.name);
+    TEST_ASSERT_EQUAL_STRING("Steam-Mecha", out.race);
+    TEST_ASSERT_EQUAL_STRING("Steam Engineer", out.pclass);
+    TEST_ASSERT_EQUAL_INT(7, out.race_idx);
+    TEST_ASSERT_EQUAL_INT(3, out.class_idx);
+    TEST_ASSERT_EQUAL_INT(0, out.is_dead);
+    TEST_ASSERT_EQUAL_INT(30, out.lev);
+    TEST_ASSERT_EQUAL_INT(12, out.depth);
+    TEST_ASSERT_EQUAL_INT(1234567L, out.turn);
+    TEST_ASSERT_TRUE(in.checksum == out.checksum);
+
+    /* Overlong names are truncated, not overflowed */
+    memset(in.race, 'x', sizeof(in.race));
+    in.race[sizeof(in.race) - 1] = '\0';
+    save_summary_encode(&in, buf);
+    TEST_ASSERT_EQUAL_INT(0, save_summary_decode(buf, SAVE_SUMMARY_SIZE, &out));
+    TEST_ASSERT_EQUAL_INT((int)sizeof(out.race) - 1, (int)strlen(out.race));
+}
+
+/* Test short and damaged chunks are rejected */
+void test_save_summary_rejects_corrupt(void) {
+    unsigned char buf[SAVE_SUMMARY_SIZE];
+    save_summary sum;
+
+    make_summary(&sum);
+    save_summary_encode(&sum, buf);
+
+    TEST_ASSERT_EQUAL_INT(-1, save_summary_decode(buf, SAVE_SUMMARY_SIZE - 1, &sum));
+
+    buf[10] ^= 0x20;
+    TEST_ASSERT_EQUAL_INT(-1, save_summary_decode(buf, SAVE_SUMMARY_SIZE, &sum));
+}
+
+/* Test probing reads the chunk from a file, and refuses older savefiles */
+void test_save_summary_probe_file(void) {
+    test_file_t tf = test_create_temp_file("test_save_summary");
+    unsigned char buf[SAVE_SUMMARY_SIZE];
+    unsigned char version[4] = { SAVE_SUMMARY_MAJOR, SAVE_SUMMARY_MINOR,
+                                 SAVE_SUMMARY_PATCH, 0 };
+    save_summary sum, out;
+    FILE *f;
+
+    TEST_ASSERT_TRUE(tf.created);
+
+    make_summary(&sum);
+    save_summary_encode(&sum, buf);
+
+    /* The rest of the savefile is never looked at */
+    f = fopen(tf.path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(version, 1, sizeof(version), f);
+    fwrite(buf, 1, sizeof(buf), f);
+    fputs("the rest of the savefile", f);
+    fclose(f);
+
+    TEST_ASSERT_EQUAL_INT(0, save_summary_probe(tf.path, &out));
+    TEST_ASSERT_EQUAL_STRING("Bryan", out.name);
+    TEST_ASSERT_EQUAL_INT(30, out.lev);
+
+    /* A savefile from before the summary existed */
+    version[2] = SAVE_SUMMARY_PATCH - 1;
+    f = fopen(tf.path, "wb");
+    TEST_ASSERT_NOT_NULL(f);
+    fwrite(version, 1, sizeof(version), f);
+    fwrite(buf, 1, sizeof(buf), f);
+    fclose(f);
+
+    TEST_ASSERT_EQUAL_INT(-1, save_summary_probe(tf.path, &out));
+
+    test_cleanup_temp_file(&tf);
+
+    /* A missing file */
+    TEST_ASSERT_EQUAL_INT(-1, save_summary_probe(tf.path, &out));
+}
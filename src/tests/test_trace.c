@@ -0,0 +1,91 @@
+/* File: src/tests/test_trace.c
+ * Tests for the game state trace (trace.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../trace.h"
+#include "test_helpers.h"
+#include <stdio.h>
+#include <string.h>
+
+/* Write a trace of "count" turns, with the checksum changed at "bad_turn" */
+static void write_trace(const char *path, long count, long bad_turn) {
+    unsigned long h = TRACE_HASH_INIT;
+    long turn;
+
+    TEST_ASSERT_EQUAL_INT(0, trace_open(path));
+    TEST_ASSERT_TRUE(trace_active());
+
+    for (turn = 1; turn <= count; turn++) {
+        h = trace_hash_u32(h, (unsigned long)turn);
+        trace_record(turn, (turn == bad_turn) ? (h ^ 1) : h);
+    }
+
+    trace_close();
+    TEST_ASSERT_FALSE(trace_active());
+}
+
+/* Test the checksum matches known FNV-1a values, on every platform */
+void test_trace_hash_known_values(void) {
+    TEST_ASSERT_TRUE(trace_hash_bytes(TRACE_HASH_INIT, "", 0) == 0x811c9dc5UL);
+    TEST_ASSERT_TRUE(trace_hash_bytes(TRACE_HASH_INIT, "a", 1) == 0xe40c292cUL);
+    TEST_ASSERT_TRUE(trace_hash_bytes(TRACE_HASH_INIT, "foobar", 6) == 0xbf9cf968UL);
+
+    /* Numbers are hashed as little-endian bytes */
+    TEST_ASSERT_TRUE(trace_hash_u32(TRACE_HASH_INIT, 0x64636261UL) ==
+                     trace_hash_bytes(TRACE_HASH_INIT, "abcd", 4));
+}
+
+/* Test identical traces compare equal, and tracing can be left off */
+void test_trace_compare_identical(void) {
+    test_file_t a = test_create_temp_file("test_trace_a");
+    test_file_t b = test_create_temp_file("test_trace_b");
+    trace_diff diff;
+
+    TEST_ASSERT_TRUE(a.created);
+    TEST_ASSERT_TRUE(b.created);
+
+    write_trace(a.path, 50, 0);
+    write_trace(b.path, 50, 0);
+
+    TEST_ASSERT_EQUAL_INT(0, trace_compare(a.path, b.path, &diff));
+
+    /* No path means no trace, and recording does nothing */
+    TEST_ASSERT_EQUAL_INT(0, trace_open(NULL));
+    TEST_ASSERT_FALSE(trace_active());
+    trace_record(1, 0);
+
+    test_cleanup_temp_file(&a);
+    test_cleanup_temp_file(&b);
+
+    /* Missing files */
+    TEST_ASSERT_EQUAL_INT(-1, trace_compare(a.path, b.path, &diff));
+}
+
+/* Test the first divergent turn is reported, including a truncated trace */
+void test_trace_compare_divergence(void) {
+    test_file_t a = test_create_temp_file("test_trace_a");
+    test_file_t b = test_create_temp_file("test_trace_b");
+    trace_diff diff;
+
+    TEST_ASSERT_TRUE(a.created);
+    TEST_ASSERT_TRUE(b.created);
+
+    write_trace(a.path, 50, 0);
+    write_trace(b.path, 50, 37);
+
+    TEST_ASSERT_EQUAL_INT(1, trace_compare(a.path, b.path, &diff));
+    TEST_ASSERT_EQUAL_INT(37, diff.turn);
+    TEST_ASSERT_EQUAL_INT(0, diff.ended);
+    TEST_ASSERT_TRUE(diff.hash_a == (diff.hash_b ^ 1));
+
+    /* The second trace stops early */
+    write_trace(b.path, 20, 0);
+
+    TEST_ASSERT_EQUAL_INT(1, trace_compare(a.path, b.path, &diff));
+    TEST_ASSERT_EQUAL_INT(21, diff.turn);
+    TEST_ASSERT_EQUAL_INT(2, diff.ended);
+
+    test_cleanup_temp_file(&a);
+    test_cleanup_temp_file(&b);
+}
@@ -0,0 +1,55 @@
+/* File: src/tests/test_worker.c
+ * Tests for background jobs (worker.c) using Unity framework
+ */
+
+#include "unity.h"
+#include "../worker.h"
+
+/* Job that records it was run with the right argument */
+static void set_flag(void *arg) {
+    *(int *)arg = 42;
+}
+
+/* Test a job runs, and waiting for it sees its result */
+void test_worker_runs_job(void) {
+    int flag = 0;
+    worker *w = worker_start(set_flag, &flag);
+
+    /* Threads unavailable: the caller runs the job itself */
+    if (!w) {
+        set_flag(&flag);
+    }
+
+    worker_wait(w);
+    TEST_ASSERT_EQUAL_INT(42, flag);
+}
+
+/* Test a job reports being done, and several jobs can run at once */
+void test_worker_done_and_concurrent(void) {
+    int flags[4] = {0, 0, 0, 0};
+    worker *w[4];
+    int i;
+
+    for (i = 0; i < 4; i++) {
+        w[i] = worker_start(set_flag, &flags[i]);
+        if (!w[i]) {
+            set_flag(&flags[i]);
+        }
+    }
+
+    /* A finished job stays done until it is waited for */
+    if (w[0]) {
+        while (!worker_done(w[0])) {
+            /* Spin */
+        }
+        TEST_ASSERT_EQUAL_INT(42, flags[0]);
+    }
+
+    for (i = 0; i < 4; i++) {
+        worker_wait(w[i]);
+        TEST_ASSERT_EQUAL_INT(42, flags[i]);
+    }
+
+    /* Waiting for nothing is harmless */
+    worker_wait(NULL);
+}
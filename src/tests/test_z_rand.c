@@ -0,0 +1,190 @@
+/* File: src/tests/test_z_rand.c
+ * Tests and microbenchmarks for the random number generators (z-rand.c)
+ * using Unity framework
+ */
+
+#include "unity.h"
+#include "../z-rand.h"
+#include "../profile.h"
+#include "test_helpers.h"
+#include <stdio.h>
+#include <string.h>
+
+#define BENCH_ROLLS 2000000
+
+/* Start the "complex" RNG in the given mode from a fixed seed */
+static void rand_start(u16b mode, u32b seed) {
+    Rand_quick = FALSE;
+    Rand_mode = mode;
+    Rand_place = 0;
+    Rand_state_init(seed);
+}
+
+/* Test the legacy generator still makes the numbers old savefiles expect */
+void test_rand_legacy_unchanged(void) {
+    static const u32b expect[6] = { 505, 61, 126, 672, 741, 325 };
+    int i;
+
+    rand_start(RAND_MODE_LEGACY, 12345);
+
+    for (i = 0; i < 6; i++) {
+        TEST_ASSERT_EQUAL_UINT32(expect[i], Rand_div(1000));
+    }
+
+    Rand_quick = TRUE;
+}
+
+/* Test the fast generator is repeatable, in range, and roughly uniform */
+void test_rand_fast_range(void) {
+    static const u32b sizes[5] = { 2, 7, 100, 1000, 0x80000001UL };
+    u32b first[8];
+    int count[10];
+    int i, j;
+
+    rand_start(RAND_MODE_FAST, 12345);
+    for (i = 0; i < 8; i++) {
+        first[i] = Rand_div(1000);
+    }
+
+    /* The same seed gives the same numbers */
+    rand_start(RAND_MODE_FAST, 12345);
+    for (i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_UINT32(first[i], Rand_div(1000));
+    }
+
+    /* Every result is in range, including ranges the old one cannot do */
+    for (j = 0; j < 5; j++) {
+        for (i = 0; i < 10000; i++) {
+            TEST_ASSERT_TRUE(Rand_div(sizes[j]) < sizes[j]);
+            TEST_ASSERT_TRUE(Rand_mod(sizes[j]) < sizes[j]);
+        }
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, Rand_div(1));
+
+    /* Ten buckets of 100000 rolls each get close to a tenth */
+    memset(count, 0, sizeof(count));
+    for (i = 0; i < 100000; i++) {
+        count[Rand_div(10)]++;
+    }
+    for (i = 0; i < 10; i++) {
+        TEST_ASSERT_INT_WITHIN(500, 10000, count[i]);
+    }
+
+    Rand_quick = TRUE;
+}
+
+/* Test a batch fill gives the same numbers as single calls, in both modes */
+void test_rand_fill_matches_div(void) {
+    u32b batch[100];
+    u16b mode;
+    int i;
+
+    for (mode = 0; mode < RAND_MODE_MAX; mode++) {
+        rand_start(mode, 777);
+        Rand_fill(batch, 100, 6);
+
+        rand_start(mode, 777);
+        for (i = 0; i < 100; i++) {
+            TEST_ASSERT_EQUAL_UINT32(batch[i], Rand_div(6));
+        }
+
+        /* And the state ends up in the same place */
+        Rand_fill(batch, 1, 0x1000);
+        rand_start(mode, 777);
+        for (i = 0; i < 100; i++) {
+            (void)Rand_div(6);
+        }
+        TEST_ASSERT_EQUAL_UINT32(batch[0], Rand_div(0x1000));
+    }
+
+    Rand_quick = TRUE;
+}
+
+/* Test rolls on one stream do not change the numbers another stream gives */
+void test_rand_streams_independent(void) {
+    u32b gen[20];
+    u16b mode;
+    int i, old;
+
+    for (mode = 0; mode < RAND_MODE_MAX; mode++) {
+        /* The level generation numbers, with nothing else going on */
+        rand_start(mode, 4242);
+        Rand_stream = RAND_STREAM_MAIN;
+        Rand_streams_init(4242);
+        old = Rand_stream_set(RAND_STREAM_GEN);
+        TEST_ASSERT_EQUAL_INT(RAND_STREAM_MAIN, old);
+        for (i = 0; i < 20; i++) {
+            gen[i] = Rand_div(1000);
+        }
+        TEST_ASSERT_EQUAL_INT(RAND_STREAM_GEN, Rand_stream_set(old));
+
+        /* Again, with monsters and the main stream busy in between */
+        rand_start(mode, 4242);
+        Rand_stream = RAND_STREAM_MAIN;
+        Rand_streams_init(4242);
+        for (i = 0; i < 20; i++) {
+            (void)Rand_div(6);
+            old = Rand_stream_set(RAND_STREAM_AI);
+            (void)Rand_div(100);
+            (void)Rand_stream_set(RAND_STREAM_GEN);
+            TEST_ASSERT_EQUAL_UINT32(gen[i], Rand_div(1000));
+            (void)Rand_stream_set(old);
+        }
+        TEST_ASSERT_EQUAL_INT(RAND_STREAM_MAIN, Rand_stream);
+
+        /* The streams do not simply repeat each other */
+        (void)Rand_stream_set(RAND_STREAM_STORE);
+        for (i = 0; i < 20 && Rand_div(1000) == gen[i]; i++) ;
+        TEST_ASSERT_TRUE(i < 20);
+        (void)Rand_stream_set(RAND_STREAM_MAIN);
+    }
+
+    Rand_quick = TRUE;
+}
+
+/* Time dice rolls with each generator (reported, not checked) */
+void test_rand_benchmark(void) {
+    static u32b batch[1000];
+    static const char *names[RAND_MODE_MAX] = { "legacy", "fast" };
+    char msg[160];
+    double start, single, normal, fill;
+    unsigned long sum;
+    u16b mode;
+    int i, j;
+
+    for (mode = 0; mode < RAND_MODE_MAX; mode++) {
+        rand_start(mode, 1);
+
+        sum = 0;
+        start = profile_now_ms();
+        for (i = 0; i < BENCH_ROLLS; i++) {
+            sum += Rand_div(6);
+        }
+        single = profile_now_ms() - start;
+
+        start = profile_now_ms();
+        for (i = 0; i < BENCH_ROLLS / 4; i++) {
+            sum += (unsigned long)Rand_normal(100, 10);
+        }
+        normal = profile_now_ms() - start;
+
+        start = profile_now_ms();
+        for (i = 0; i < BENCH_ROLLS / 1000; i++) {
+            Rand_fill(batch, 1000, 6);
+            for (j = 0; j < 1000; j++) {
+                sum += batch[j];
+            }
+        }
+        fill = profile_now_ms() - start;
+
+        TEST_ASSERT_TRUE(sum > 0);
+
+        snprintf(msg, sizeof(msg),
+                 "%s: %d x Rand_div(6) %.1f ms, %d x Rand_normal() %.1f ms, "
+                 "Rand_fill() %.1f ms",
+                 names[mode], BENCH_ROLLS, single, BENCH_ROLLS / 4, normal, fill);
+        TEST_MESSAGE(msg);
+    }
+
+    Rand_quick = TRUE;
+}
@@ -53,6 +53,42 @@ extern void test_controller_menu_mutual_exclusivity(void);
 extern void test_controller_mapping_count_consistency(void);
 extern void test_controller_invalid_mapping_index(void);
 
+/* Forward declarations for startup profiler tests */
+extern void test_profile_nested_phases(void);
+extern void test_profile_overflow_and_unbalanced(void);
+extern void test_profile_json_report(void);
+
+/* Forward declarations for savefile compression tests */
+extern void test_compress_round_trip_repetitive(void);
+extern void test_compress_round_trip_incompressible(void);
+extern void test_compress_rejects_corrupt_input(void);
+
+/* Forward declarations for background job tests */
+extern void test_worker_runs_job(void);
+extern void test_worker_done_and_concurrent(void);
+
+/* Forward declarations for savefile summary tests */
+extern void test_save_summary_round_trip(void);
+extern void test_save_summary_rejects_corrupt(void);
+extern void test_save_summary_probe_file(void);
+
+/* Forward declarations for state trace tests */
+extern void test_trace_hash_known_values(void);
+extern void test_trace_compare_identical(void);
+extern void test_trace_compare_divergence(void);
+
+/* Forward declarations for keystroke replay tests */
+extern void test_replay_round_trip(void);
+extern void test_replay_rng_state(void);
+extern void test_replay_rejects_bad_file(void);
+
+/* Forward declarations for random number generator tests */
+extern void test_rand_legacy_unchanged(void);
+extern void test_rand_fast_range(void);
+extern void test_rand_fill_matches_div(void);
+extern void test_rand_streams_independent(void);
+extern void test_rand_benchmark(void);
+
 int main(void) {
     UNITY_BEGIN();
     
@@ -102,6 +138,42 @@ int main(void) {
     RUN_TEST(test_controller_mapping_count_consistency);
     RUN_TEST(test_controller_invalid_mapping_index);
     
+    /* Run startup profiler tests */
+    RUN_TEST(test_profile_nested_phases);
+    RUN_TEST(test_profile_overflow_and_unbalanced);
+    RUN_TEST(test_profile_json_report);
+    
+    /* Run savefile compression tests */
+    RUN_TEST(test_compress_round_trip_repetitive);
+    RUN_TEST(test_compress_round_trip_incompressible);
+    RUN_TEST(test_compress_rejects_corrupt_input);
+
+    /* Run background job tests */
+    RUN_TEST(test_worker_runs_job);
+    RUN_TEST(test_worker_done_and_concurrent);
+
+    /* Run savefile summary tests */
+    RUN_TEST(test_save_summary_round_trip);
+    RUN_TEST(test_save_summary_rejects_corrupt);
+    RUN_TEST(test_save_summary_probe_file);
+
+    /* Run state trace tests */
+    RUN_TEST(test_trace_hash_known_values);
+    RUN_TEST(test_trace_compare_identical);
+    RUN_TEST(test_trace_compare_divergence);
+
+    /* Run keystroke replay tests */
+    RUN_TEST(test_replay_round_trip);
+    RUN_TEST(test_replay_rng_state);
+    RUN_TEST(test_replay_rejects_bad_file);
+
+    /* Run random number generator tests */
+    RUN_TEST(test_rand_legacy_unchanged);
+    RUN_TEST(test_rand_fast_range);
+    RUN_TEST(test_rand_fill_matches_div);
+    RUN_TEST(test_rand_streams_independent);
+    RUN_TEST(test_rand_benchmark);
+    
     return UNITY_END();
 }
 
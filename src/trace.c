@@ -0,0 +1,142 @@
+/* File: trace.c */
+#include "trace.h"
+#include "logging.h"
+#include <stdio.h>
+#include <string.h>
+
+#define FNV_PRIME 16777619UL
+
+static FILE *trace_fp = NULL;
+
+unsigned long trace_hash_bytes(unsigned long h, const void *buf, size_t len) {
+    const unsigned char *p = (const unsigned char *)buf;
+    size_t i;
+
+    for (i = 0; i < len; i++) {
+        h ^= p[i];
+        h = (h * FNV_PRIME) & 0xFFFFFFFFUL;
+    }
+
+    return h;
+}
+
+unsigned long trace_hash_u32(unsigned long h, unsigned long v) {
+    unsigned char b[4];
+
+    b[0] = (unsigned char)(v & 0xFF);
+    b[1] = (unsigned char)((v >> 8) & 0xFF);
+    b[2] = (unsigned char)((v >> 16) & 0xFF);
+    b[3] = (unsigned char)((v >> 24) & 0xFF);
+
+    return trace_hash_bytes(h, b, 4);
+}
+
+int trace_open(const char *path) {
+    trace_close();
+
+    if (!path || !path[0]) {
+        return 0;
+    }
+
+    trace_fp = fopen(path, "w");
+    if (!trace_fp) {
+        LOG_W("State trace: Failed to open %s for writing", path);
+        return -1;
+    }
+
+    fprintf(trace_fp, "# turn checksum\n");
+
+    LOG_I("State trace: Writing %s", path);
+
+    return 0;
+}
+
+int trace_active(void) {
+    return trace_fp != NULL;
+}
+
+void trace_record(long turn, unsigned long hash) {
+    if (!trace_fp) {
+        return;
+    }
+
+    fprintf(trace_fp, "%ld %08lx\n", turn, hash & 0xFFFFFFFFUL);
+}
+
+void trace_close(void) {
+    if (!trace_fp) {
+        return;
+    }
+
+    fclose(trace_fp);
+    trace_fp = NULL;
+}
+
+/*
+ * Read the next "turn checksum" line, skipping comments
+ * @return: 1 if a line was read, 0 at the end of the file
+ */
+static int read_entry(FILE *fp, long *line, long *turn, unsigned long *hash) {
+    char buf[128];
+
+    while (fgets(buf, sizeof(buf), fp)) {
+        (*line)++;
+
+        if (buf[0] == '#') {
+            continue;
+        }
+
+        if (sscanf(buf, "%ld %lx", turn, hash) == 2) {
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+int trace_compare(const char *path_a, const char *path_b, trace_diff *diff) {
+    FILE *fa, *fb;
+    long line_a = 0, line_b = 0;
+    long turn_a, turn_b;
+    unsigned long hash_a, hash_b;
+    int more_a, more_b;
+    int result = 0;
+
+    fa = fopen(path_a, "r");
+    if (!fa) {
+        return -1;
+    }
+
+    fb = fopen(path_b, "r");
+    if (!fb) {
+        fclose(fa);
+        return -1;
+    }
+
+    while (1) {
+        more_a = read_entry(fa, &line_a, &turn_a, &hash_a);
+        more_b = read_entry(fb, &line_b, &turn_b, &hash_b);
+
+        /* Both finished together */
+        if (!more_a && !more_b) {
+            break;
+        }
+
+        /* One finished early, or the turns or checksums differ */
+        if (!more_a || !more_b || turn_a != turn_b || hash_a != hash_b) {
+            memset(diff, 0, sizeof(*diff));
+            diff->line = more_a ? line_a : line_b;
+            diff->turn = more_a ? turn_a : turn_b;
+            diff->hash_a = more_a ? hash_a : 0;
+            diff->hash_b = more_b ? hash_b : 0;
+            diff->ended = !more_a ? 1 : (!more_b ? 2 : 0);
+            result = 1;
+            break;
+        }
+    }
+
+    fclose(fa);
+    fclose(fb);
+
+    return result;
+}
@@ -0,0 +1,73 @@
+/* File: trace.h */
+#ifndef INCLUDED_TRACE_H
+#define INCLUDED_TRACE_H
+
+#include <stddef.h>
+
+/*
+ * Starting value of a checksum
+ */
+#define TRACE_HASH_INIT 2166136261UL
+
+/*
+ * Add bytes to a 32-bit checksum (FNV-1a)
+ * @param h: Checksum so far
+ * @return: The new checksum
+ */
+unsigned long trace_hash_bytes(unsigned long h, const void *buf, size_t len);
+
+/*
+ * Add a number to a checksum
+ * The number is hashed as four little-endian bytes, so the result does
+ * not depend on the compiler or platform.
+ */
+unsigned long trace_hash_u32(unsigned long h, unsigned long v);
+
+/*
+ * Start writing a trace of per-turn checksums
+ * @param path: Trace file (NULL or "" to leave tracing off)
+ * @return: 0 on success (or if tracing is off), -1 if the file could
+ *          not be opened
+ */
+int trace_open(const char *path);
+
+/*
+ * Check whether a trace is being written
+ * @return: 1 if so, 0 if not
+ */
+int trace_active(void);
+
+/*
+ * Add a line to the trace (if one is being written)
+ * @param turn: Game turn
+ * @param hash: Checksum of the game state at the end of the turn
+ */
+void trace_record(long turn, unsigned long hash);
+
+/*
+ * Finish writing the trace
+ */
+void trace_close(void);
+
+/*
+ * Where two traces part ways
+ */
+typedef struct {
+    long line;              /* Line of the first difference (from 1) */
+    long turn;              /* Game turn of the first difference */
+    unsigned long hash_a;   /* Checksum in the first trace */
+    unsigned long hash_b;   /* Checksum in the second trace */
+    int ended;              /* 1 or 2 if that trace ended first, else 0 */
+} trace_diff;
+
+/*
+ * Find the first turn where two traces differ
+ * @param path_a: First trace
+ * @param path_b: Second trace
+ * @param diff: Where they differ (only set if they do)
+ * @return: 0 if the traces are identical, 1 if they differ, -1 if
+ *          either could not be read
+ */
+int trace_compare(const char *path_a, const char *path_b, trace_diff *diff);
+
+#endif /* INCLUDED_TRACE_H */
@@ -0,0 +1,45 @@
+/* File: tracecmp.c */
+
+/*
+ * Compare two state traces (see trace.c) and report the first turn where
+ * they differ.  Traces are written by the game when STEAMBAND_TRACE names
+ * a file; two builds replaying the same savefile with the same keys should
+ * produce identical traces.
+ *
+ * Exit status is 0 if the traces match, 1 if they differ, 2 on error.
+ */
+
+#include "trace.h"
+#include <stdio.h>
+
+int main(int argc, char *argv[]) {
+    trace_diff diff;
+    int result;
+
+    if (argc != 3) {
+        fprintf(stderr, "usage: %s <trace-a> <trace-b>\n", argv[0]);
+        return 2;
+    }
+
+    result = trace_compare(argv[1], argv[2], &diff);
+
+    if (result < 0) {
+        fprintf(stderr, "%s: cannot read %s or %s\n", argv[0], argv[1], argv[2]);
+        return 2;
+    }
+
+    if (result == 0) {
+        printf("Traces match\n");
+        return 0;
+    }
+
+    if (diff.ended) {
+        printf("%s ends before turn %ld (line %ld)\n",
+               diff.ended == 1 ? argv[1] : argv[2], diff.turn, diff.line);
+    } else {
+        printf("First divergence at turn %ld (line %ld): %08lx != %08lx\n",
+               diff.turn, diff.line, diff.hash_a, diff.hash_b);
+    }
+
+    return 1;
+}
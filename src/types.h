@@ -417,6 +417,38 @@ struct vault_type
 };
 
 
+/*
+ * A grid of a vault, compiled from its layout (see "init_v_plan()")
+ */
+typedef struct vault_grid vault_grid;
+struct vault_grid
+{
+	byte y;				/* Row, from the top of the vault */
+	byte x;				/* Column, from the left of the vault */
+
+	byte feat;			/* Feature to lay down */
+	byte what;			/* Thing to place (VAULT_*), if any */
+};
+
+
+/*
+ * A vault, compiled from its layout
+ *
+ * "grid" holds every grid of the vault with its feature, then the grids
+ * with traps or treasure, then the grids with monsters or objects, each
+ * list in the order of the layout.
+ */
+typedef struct vault_plan vault_plan;
+struct vault_plan
+{
+	u16b grid_num;		/* Number of grids in the vault */
+	u16b trap_num;		/* Number of grids with traps or treasure */
+	u16b life_num;		/* Number of grids with monsters or objects */
+
+	vault_grid *grid;	/* The three lists, one after another */
+};
+
+
 
 /*
  * Object information, for a specific object.
@@ -1184,3 +1216,34 @@ struct mind_power
 {
 	mind_type info[MAX_CLASS_POWERS];
 };
+
+
+/*
+ * Statistics about the making of one level (see "gen_bench.c")
+ */
+typedef struct gen_stats_type gen_stats_type;
+struct gen_stats_type
+{
+	u32b seed;			/* Seed of the level generation stream */
+	s16b depth;			/* Depth of the level */
+
+	s16b rooms;			/* Rooms built */
+	s16b vaults;		/* Vaults built */
+	s16b retries;		/* Levels rejected before this one */
+	s16b objects;		/* Objects on the level */
+	s16b monsters;		/* Monsters on the level */
+
+	double total;		/* Time to make the level (msec) */
+	double ms[GEN_PHASE_MAX];	/* Time in each phase (msec) */
+};
+
+
+/*
+ * A copy of the game state (see "snapshot.c")
+ */
+typedef struct snapshot_type snapshot_type;
+struct snapshot_type
+{
+	u32b size;			/* Size of the copy */
+	byte *buf;			/* The copy */
+};
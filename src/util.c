@@ -1719,6 +1719,13 @@ char inkey(void)
 		/* Hack -- Flush output once when no key ready */
 		if (!done && (0 != Term_inkey(&kk, FALSE, FALSE)))
 		{
+			/* Hack -- show any map grids waiting to be redrawn */
+			if (character_generated && !character_icky &&
+			    (p_ptr->redraw & (PR_SPOTS)))
+			{
+				prt_dirty_spots();
+			}
+
 			/* Hack -- activate proper term */
 			Term_activate(old);
 
@@ -1736,6 +1743,11 @@ char inkey(void)
 
 			/* Only once */
 			done = TRUE;
+
+			/* Make the next levels while waiting for a command */
+			while (inkey_flag && !character_icky &&
+			       (0 != Term_inkey(&kk, FALSE, FALSE)) &&
+			       level_cache_spare()) /* loop */;
 		}
 
 
@@ -2466,6 +2478,72 @@ void messages_free(void)
 }
 
 
+/*
+ * Size of a copy of the message log (see "messages_copy()")
+ */
+#define MESSAGE_COPY_SIZE \
+	(4 * sizeof(u16b) + 3 * MESSAGE_MAX * sizeof(u16b) + MESSAGE_BUF)
+
+
+/*
+ * Copy the message log, so that it can be put back with "messages_restore()"
+ *
+ * The game state snapshots do not include the message log.
+ */
+byte *messages_copy(void)
+{
+	byte *buf, *s;
+
+	/* Make room */
+	C_MAKE(buf, MESSAGE_COPY_SIZE, byte);
+	s = buf;
+
+	/* The indexes */
+	COPY(s, &message__next, u16b); s += sizeof(u16b);
+	COPY(s, &message__last, u16b); s += sizeof(u16b);
+	COPY(s, &message__head, u16b); s += sizeof(u16b);
+	COPY(s, &message__tail, u16b); s += sizeof(u16b);
+
+	/* The messages */
+	C_COPY(s, message__ptr, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(s, message__type, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(s, message__count, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(s, message__buf, MESSAGE_BUF, char);
+
+	return (buf);
+}
+
+
+/*
+ * Put back a copy of the message log made by "messages_copy()", and free it
+ */
+void messages_restore(byte *buf)
+{
+	byte *s = buf;
+
+	/* The indexes */
+	COPY(&message__next, s, u16b); s += sizeof(u16b);
+	COPY(&message__last, s, u16b); s += sizeof(u16b);
+	COPY(&message__head, s, u16b); s += sizeof(u16b);
+	COPY(&message__tail, s, u16b); s += sizeof(u16b);
+
+	/* The messages */
+	C_COPY(message__ptr, s, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(message__type, s, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(message__count, s, MESSAGE_MAX * sizeof(u16b), byte);
+	s += MESSAGE_MAX * sizeof(u16b);
+	C_COPY(message__buf, s, MESSAGE_BUF, char);
+
+	/* Free the copy */
+	C_KILL(buf, MESSAGE_COPY_SIZE, byte);
+}
+
+
 /*
  * XXX XXX XXX Important note about "colors" XXX XXX XXX
  *
@@ -2593,6 +2671,9 @@ static void msg_print_aux(u16b type, cptr msg)
 	int w, h;
 
 
+	/* Hack -- Nothing is shown or remembered (see "level_cache_spare()") */
+	if (msg_silent) return;
+
 	/* Obtain the size */
 	(void)Term_get_size(&w, &h);
 
@@ -2747,6 +2828,9 @@ void message(u16b message_type, s16b extra, cptr message)
 	/* Unused parameter */
 	(void)extra;
 
+	/* Hack -- Not even a sound */
+	if (msg_silent) return;
+
 	sound(message_type);
 
 	msg_print_aux(message_type, message);
@@ -3651,15 +3735,21 @@ void request_command(bool shopping)
  */
 uint damroll(uint num, uint sides)
 {
-	uint i, sum = 0;
+	u32b roll[16];
+	uint i, n, sum = num;
 
 
 	/* HACK - rand_die(0) is undefined */
 	if (sides == 0) return (0);
 
-	for (i = 0; i < num; i++)
+	/* Roll the dice a handful at a time (each die counts from one) */
+	for (; num; num -= n)
 	{
-		sum += rand_die(sides);
+		n = MIN(num, 16);
+
+		Rand_fill(roll, (int)n, sides);
+
+		for (i = 0; i < n; i++) sum += roll[i];
 	}
 
 	return (sum);
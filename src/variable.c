@@ -84,6 +84,15 @@ s32b turn;				/* Current game turn */
 
 s32b old_turn;			/* Hack -- Level feeling counter */
 
+u32b state_checksum;	/* Checksum of the game state after each turn */
+
+gen_stats_type *gen_stats;	/* Level generation statistics, if being gathered */
+
+u32b map_frames;		/* Number of times map grids were redrawn */
+u32b map_grids;			/* Total number of map grids redrawn */
+u16b map_grids_last;	/* Number of map grids redrawn the last time */
+u32b map_changes;		/* Number of changes to the appearance of the map */
+
 bool use_sound;			/* The "sound" mode is enabled */
 bool use_graphics;		/* The "graphics" mode is enabled */
 
@@ -91,6 +100,8 @@ s16b signal_count;		/* Hack -- Count interrupts */
 
 bool msg_flag;			/* Player has pending message */
 
+bool msg_silent;		/* Hack -- messages are being dropped */
+
 bool inkey_base;		/* See the "inkey()" function */
 bool inkey_xtra;		/* See the "inkey()" function */
 bool inkey_scan;		/* See the "inkey()" function */
@@ -461,6 +472,11 @@ vault_type *v_info;
 char *v_name;
 char *v_text;
 
+/*
+ * The vaults, compiled from "v_text"
+ */
+vault_plan *v_plan;
+
 /*
  * The terrain feature arrays
  */
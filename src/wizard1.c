@@ -925,7 +925,7 @@ static void analyze_misc(const object_type *o_ptr, char *misc_desc)
 
 	sprintf(misc_desc, "Level %u, Rarity %u, %d.%d lbs, %ld Gold",
 	        a_ptr->level, a_ptr->rarity,
-	        a_ptr->weight / 10, a_ptr->weight % 10, a_ptr->cost);
+	        a_ptr->weight / 10, a_ptr->weight % 10, (long)a_ptr->cost);
 }
 
 
@@ -1655,9 +1655,12 @@ static void spoil_mon_info(cptr fname)
 		spoil_out(buf);
 
 
-		/* Describe */
-		spoil_out(r_text + r_ptr->text);
-		spoil_out("  ");
+		/* Describe (loaded on demand) */
+		if (!load_info_text(&r_text))
+		{
+			spoil_out(r_text + r_ptr->text);
+			spoil_out("  ");
+		}
 
 
 		spoil_out("This");
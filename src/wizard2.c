@@ -10,6 +10,9 @@
 
 #include "angband.h"
 
+#include "logging.h"
+#include "profile.h"
+
 
 
 #ifdef ALLOW_DEBUG
@@ -864,7 +867,7 @@ static void wiz_quantity_item(object_type *o_ptr, bool carried)
 
 
 	/* Default */
-	sprintf(tmp_val, "%d", o_ptr->number);
+	strnfmt(tmp_val, sizeof(tmp_val), "%d", o_ptr->number);
 
 	/* Query */
 	if (get_string("Quantity: ", tmp_val, 3))
@@ -1468,6 +1471,340 @@ static void do_cmd_wiz_query(void)
 
 
 
+/*
+ * Number of replays timed by the snapshot benchmark
+ */
+#define SNAPSHOT_BENCH_RUNS		100
+
+/*
+ * Number of game turns of monster moves in each replay
+ */
+#define SNAPSHOT_BENCH_TURNS	10
+
+
+/*
+ * Benchmark monster moves by replaying them from a snapshot
+ *
+ * Every replay starts from the same snapshot of the current situation, so
+ * each one runs exactly the same moves.  This also checks that snapshots
+ * capture everything the monsters depend on: every replay must end in the
+ * same state as the first one.
+ */
+static void do_cmd_wiz_snapshot_bench(void)
+{
+	snapshot_type *start_ptr, *end_ptr = NULL, *s_ptr;
+
+	int n, i;
+
+	u32b size;
+
+	double start, take, restore = 0.0, moves = 0.0;
+
+	bool same = TRUE;
+
+	bool old_auto_more = auto_more;
+
+
+	/* Do not stop for messages */
+	auto_more = TRUE;
+
+	/* Snapshot the situation */
+	start = profile_now_ms();
+	start_ptr = snapshot_take();
+	take = profile_now_ms() - start;
+	size = start_ptr->size;
+
+	for (n = 0; n < SNAPSHOT_BENCH_RUNS; n++)
+	{
+		/* Go back to the start */
+		start = profile_now_ms();
+		(void)snapshot_restore(start_ptr);
+		restore += profile_now_ms() - start;
+
+		/* Let the monsters move */
+		start = profile_now_ms();
+		for (i = 0; i < SNAPSHOT_BENCH_TURNS; i++)
+		{
+			process_monsters(100);
+		}
+		moves += profile_now_ms() - start;
+
+		/* Compare the outcome with the first replay */
+		s_ptr = snapshot_take();
+		if (!end_ptr)
+		{
+			end_ptr = s_ptr;
+		}
+		else
+		{
+			if (!snapshot_same(end_ptr, s_ptr)) same = FALSE;
+			snapshot_free(s_ptr);
+		}
+	}
+
+	/* Leave things as they were */
+	(void)snapshot_restore(start_ptr);
+	snapshot_free(start_ptr);
+	if (end_ptr) snapshot_free(end_ptr);
+
+	auto_more = old_auto_more;
+
+	/* Report */
+	LOG_I("Snapshot benchmark: %lu bytes, take %.3f ms, restore %.3f ms, "
+	      "%d monster turns %.3f ms (%s)", (unsigned long)size,
+	      take, restore / SNAPSHOT_BENCH_RUNS, SNAPSHOT_BENCH_TURNS,
+	      moves / SNAPSHOT_BENCH_RUNS, same ? "deterministic" : "diverged");
+
+	msg_format("Snapshot: %lu bytes, restore %.3f ms, replays %s.",
+	           (unsigned long)size, restore / SNAPSHOT_BENCH_RUNS,
+	           same ? "identical" : "DIVERGED");
+}
+
+
+/*
+ * Number of loads timed by the savefile benchmark
+ */
+#define LOAD_BENCH_RUNS		20
+
+
+/*
+ * Report how many map grids have been redrawn, and reset the counts
+ */
+static void do_cmd_wiz_map_stats(void)
+{
+	/* Report */
+	msg_format("Map: %lu grids in %lu frames (%lu per frame), %d last frame.",
+	           (unsigned long)map_grids, (unsigned long)map_frames,
+	           (unsigned long)(map_frames ? map_grids / map_frames : 0),
+	           (int)map_grids_last);
+
+	/* Start counting again */
+	map_frames = 0L;
+	map_grids = 0L;
+}
+
+
+/*
+ * Benchmark level generation
+ *
+ * Makes GEN_BENCH_LEVELS levels (see "gen_bench()"), writing one line per
+ * level to "genbench.csv" in the user directory and a summary to the log.
+ */
+static void do_cmd_wiz_gen_bench(void)
+{
+	char buf[1024];
+
+
+	/* Build the filename */
+	path_build(buf, 1024, ANGBAND_DIR_USER, "genbench.csv");
+
+	/* Make the levels */
+	if (gen_bench(buf, GEN_BENCH_LEVELS))
+	{
+		msg_format("Could not write %s.", buf);
+		return;
+	}
+
+	msg_format("Made %d levels, see %s and the log.", GEN_BENCH_LEVELS, buf);
+}
+
+
+/*
+ * Benchmark savefile loading
+ *
+ * First make the game look like a veteran's -- a full home, complete
+ * monster memory, and a level crowded with monsters and objects -- then
+ * save it to a scratch savefile and time reloading that several times.
+ *
+ * Each load rebuilds the current game state from the savefile, so the
+ * state that loading accumulates into is cleared beforehand.  Afterwards
+ * the game, the message log and the savefile details are put back as they
+ * were, and the scratch savefile is deleted; the real savefile is never
+ * touched.
+ */
+static void do_cmd_wiz_load_bench(void)
+{
+	store_type *st_ptr = &store[STORE_HOME];
+
+	object_type *i_ptr;
+
+	snapshot_type *s_ptr;
+
+	byte *m_ptr;
+
+	int i, n, y, x;
+
+	double start, best = 0.0, total = 0.0;
+
+	errr err = 0;
+
+	char real[1024];
+
+	/* Savefile details, which saving and loading change */
+	byte old_major = sf_major, old_minor = sf_minor;
+	byte old_patch = sf_patch, old_extra = sf_extra;
+	u32b old_xtra = sf_xtra, old_when = sf_when;
+	u16b old_lives = sf_lives, old_saves = sf_saves;
+	bool old_saved = character_saved;
+
+
+	/* Finish any background save first */
+	if (!save_player_wait()) msg_print("Autosave failed!");
+
+	/* Remember the game and the messages */
+	s_ptr = snapshot_take();
+	m_ptr = messages_copy();
+
+	/* Fill the home */
+	for (i = 0; (st_ptr->stock_num < st_ptr->stock_size) && (i < 1000); i++)
+	{
+		/* Get the next slot */
+		i_ptr = &st_ptr->stock[st_ptr->stock_num];
+
+		/* Wipe the object */
+		object_wipe(i_ptr);
+
+		/* Make an object */
+		if (!make_object(i_ptr, FALSE, FALSE)) continue;
+
+		/* Identify it */
+		object_known(i_ptr);
+
+		/* Keep it */
+		st_ptr->stock_num++;
+	}
+
+	/* Learn everything about every monster */
+	for (i = 1; i < z_info->r_max; i++)
+	{
+		monster_race *r_ptr = &r_info[i];
+		monster_lore *l_ptr = &l_list[i];
+
+		/* Skip unused races */
+		if (!r_ptr->name) continue;
+
+		/* Maximal memory */
+		l_ptr->r_sights = l_ptr->r_tkills = MAX_SHORT;
+		l_ptr->r_wake = l_ptr->r_ignore = MAX_UCHAR;
+		l_ptr->r_drop_gold = l_ptr->r_drop_item = MAX_UCHAR;
+		l_ptr->r_cast_inate = l_ptr->r_cast_spell = MAX_UCHAR;
+
+		for (n = 0; n < 4; n++) l_ptr->r_blows[n] = MAX_UCHAR;
+
+		/* Know all the flags */
+		l_ptr->r_flags1 = r_ptr->flags1;
+		l_ptr->r_flags2 = r_ptr->flags2;
+		l_ptr->r_flags3 = r_ptr->flags3;
+		l_ptr->r_flags4 = r_ptr->flags4;
+		l_ptr->r_flags5 = r_ptr->flags5;
+		l_ptr->r_flags6 = r_ptr->flags6;
+		l_ptr->r_flags7 = r_ptr->flags7;
+	}
+
+	/* Crowd the level with monsters */
+	for (i = 0; (m_cnt < z_info->m_max / 2) && (i < 1000); i++)
+	{
+		(void)alloc_monster(0, TRUE);
+	}
+
+	/* Crowd the level with objects */
+	for (i = 0; (o_cnt < z_info->o_max / 2) && (i < 10000); i++)
+	{
+		/* Pick a location */
+		y = rand_int(DUNGEON_HGT);
+		x = rand_int(DUNGEON_WID);
+
+		/* Require a clean floor grid */
+		if (!in_bounds_fully(y, x) || !cave_clean_bold(y, x)) continue;
+
+		/* Place an object */
+		place_object(y, x, FALSE, FALSE);
+	}
+
+	/* Use a scratch savefile */
+	my_strcpy(real, savefile, sizeof(real));
+	strnfmt(savefile, sizeof(savefile), "%s.bench", real);
+
+	/* Save the veteran */
+	if (!save_player()) err = -1;
+
+	/* Time the loads */
+	for (n = 0; !err && (n < LOAD_BENCH_RUNS); n++)
+	{
+		/* Forget the level */
+		wipe_o_list();
+		wipe_m_list();
+
+		/* Forget the player */
+		cave_m_idx[p_ptr->py][p_ptr->px] = 0;
+
+		/* Forget the inventory totals */
+		p_ptr->inven_cnt = 0;
+		p_ptr->equip_cnt = 0;
+		p_ptr->total_weight = 0;
+
+		/* Forget the store contents */
+		for (i = 0; i < MAX_STORES; i++) store[i].stock_num = 0;
+
+		start = profile_now_ms();
+
+		/* Load the savefile */
+		err = rd_savefile_new();
+
+		start = profile_now_ms() - start;
+
+		/* Oops */
+		if (err) break;
+
+		total += start;
+		if (!n || (start < best)) best = start;
+	}
+
+	/* Delete the scratch savefile */
+	safe_setuid_grab();
+	fd_kill(savefile);
+	safe_setuid_drop();
+
+	/* Back to the real savefile */
+	my_strcpy(savefile, real, sizeof(savefile));
+
+	/* Put back the game, loaded or not, and the messages */
+	(void)snapshot_restore(s_ptr);
+	snapshot_free(s_ptr);
+	messages_restore(m_ptr);
+
+	/* Put back the savefile details */
+	sf_major = old_major;
+	sf_minor = old_minor;
+	sf_patch = old_patch;
+	sf_extra = old_extra;
+	sf_xtra = old_xtra;
+	sf_when = old_when;
+	sf_lives = old_lives;
+	sf_saves = old_saves;
+	character_saved = old_saved;
+
+	/* Failure */
+	if (err)
+	{
+		msg_print("Saving or loading the scratch savefile failed!");
+		return;
+	}
+
+	/* Report */
+	msg_format("Loaded %d times: %.2f ms average, %.2f ms best.",
+	           LOAD_BENCH_RUNS, total / LOAD_BENCH_RUNS, best);
+	LOG_I("Load benchmark: %d loads, %.3f ms average, %.3f ms best",
+	      LOAD_BENCH_RUNS, total / LOAD_BENCH_RUNS, best);
+
+	/* Update everything */
+	p_ptr->update |= (PU_BONUS | PU_TORCH | PU_UPDATE_VIEW | PU_MONSTERS);
+	p_ptr->redraw |= (PR_MAP);
+	p_ptr->window |= (PW_INVEN | PW_EQUIP);
+}
+
+
+
 #ifdef ALLOW_SPOILERS
 
 /*
@@ -1618,6 +1955,34 @@ void do_cmd_debug(void)
 			break;
 		}
 
+		/* Count redrawn map grids */
+		case 'G':
+		{
+			do_cmd_wiz_map_stats();
+			break;
+		}
+
+		/* Benchmark savefile loading */
+		case 'L':
+		{
+			do_cmd_wiz_load_bench();
+			break;
+		}
+
+		/* Benchmark replaying monster turns from a snapshot */
+		case 'S':
+		{
+			do_cmd_wiz_snapshot_bench();
+			break;
+		}
+
+		/* Benchmark level generation */
+		case 'D':
+		{
+			do_cmd_wiz_gen_bench();
+			break;
+		}
+
 		/* Magic Mapping */
 		case 'm':
 		{
@@ -0,0 +1,143 @@
+/* File: worker.c */
+#include "worker.h"
+#include "logging.h"
+#include <stdlib.h>
+
+#ifdef WINDOWS
+#include <windows.h>
+#elif defined(__unix__) || defined(__APPLE__)
+#include <pthread.h>
+#define WORKER_PTHREADS
+#endif
+
+struct worker {
+    worker_func func;
+    void *arg;
+#ifdef WINDOWS
+    HANDLE thread;
+    volatile LONG done;
+#elif defined(WORKER_PTHREADS)
+    pthread_t thread;
+    pthread_mutex_t lock;
+    int done;
+#endif
+};
+
+#ifdef WINDOWS
+
+static DWORD WINAPI worker_main(LPVOID param) {
+    worker *w = (worker *)param;
+
+    w->func(w->arg);
+    InterlockedExchange(&w->done, 1);
+
+    return 0;
+}
+
+worker *worker_start(worker_func func, void *arg) {
+    worker *w = (worker *)calloc(1, sizeof(worker));
+
+    if (!w) {
+        return NULL;
+    }
+
+    w->func = func;
+    w->arg = arg;
+
+    w->thread = CreateThread(NULL, 0, worker_main, w, 0, NULL);
+    if (!w->thread) {
+        LOG_W("Worker: CreateThread failed (%lu)", (unsigned long)GetLastError());
+        free(w);
+        return NULL;
+    }
+
+    return w;
+}
+
+int worker_done(worker *w) {
+    return InterlockedCompareExchange(&w->done, 1, 1) == 1;
+}
+
+void worker_wait(worker *w) {
+    if (!w) {
+        return;
+    }
+
+    WaitForSingleObject(w->thread, INFINITE);
+    CloseHandle(w->thread);
+    free(w);
+}
+
+#elif defined(WORKER_PTHREADS)
+
+static void *worker_main(void *param) {
+    worker *w = (worker *)param;
+
+    w->func(w->arg);
+
+    pthread_mutex_lock(&w->lock);
+    w->done = 1;
+    pthread_mutex_unlock(&w->lock);
+
+    return NULL;
+}
+
+worker *worker_start(worker_func func, void *arg) {
+    worker *w = (worker *)calloc(1, sizeof(worker));
+
+    if (!w) {
+        return NULL;
+    }
+
+    w->func = func;
+    w->arg = arg;
+    pthread_mutex_init(&w->lock, NULL);
+
+    if (pthread_create(&w->thread, NULL, worker_main, w) != 0) {
+        LOG_W("Worker: pthread_create failed");
+        pthread_mutex_destroy(&w->lock);
+        free(w);
+        return NULL;
+    }
+
+    return w;
+}
+
+int worker_done(worker *w) {
+    int done;
+
+    pthread_mutex_lock(&w->lock);
+    done = w->done;
+    pthread_mutex_unlock(&w->lock);
+
+    return done;
+}
+
+void worker_wait(worker *w) {
+    if (!w) {
+        return;
+    }
+
+    pthread_join(w->thread, NULL);
+    pthread_mutex_destroy(&w->lock);
+    free(w);
+}
+
+#else /* No threads */
+
+worker *worker_start(worker_func func, void *arg) {
+    (void)func;
+    (void)arg;
+    return NULL;
+}
+
+int worker_done(worker *w) {
+    (void)w;
+    return 1;
+}
+
+void worker_wait(worker *w) {
+    (void)w;
+}
+
+#endif
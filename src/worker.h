@@ -0,0 +1,39 @@
+/* File: worker.h */
+#ifndef INCLUDED_WORKER_H
+#define INCLUDED_WORKER_H
+
+/*
+ * A job to run on a background thread
+ * The job must not touch game state or the terminal; it only gets what
+ * it is handed in "arg".
+ */
+typedef void (*worker_func)(void *arg);
+
+/*
+ * Handle of a running (or finished) job
+ */
+typedef struct worker worker;
+
+/*
+ * Start running a job on a new thread
+ * @param func: Job to run
+ * @param arg: Argument passed to the job
+ * @return: Handle of the job, or NULL if no thread could be started
+ *          (or threads are not supported), in which case the caller
+ *          should run the job itself
+ */
+worker *worker_start(worker_func func, void *arg);
+
+/*
+ * Check whether a job has finished, without waiting
+ * @return: 1 if the job has finished, 0 if it is still running
+ */
+int worker_done(worker *w);
+
+/*
+ * Wait for a job to finish, then free its handle
+ * @param w: Handle from worker_start() (NULL is ignored)
+ */
+void worker_wait(worker *w);
+
+#endif /* INCLUDED_WORKER_H */
@@ -10,6 +10,8 @@
 
 #include "angband.h"
 
+#include "profile.h"
+
 
 
 
@@ -1039,6 +1041,25 @@ static void fix_message(void)
 }
 
 
+/*
+ * What each overhead view showed when it was last drawn
+ */
+typedef struct overhead_type overhead_type;
+
+struct overhead_type
+{
+	bool drawn;		/* The view has been drawn */
+
+	u32b changes;	/* Value of "map_changes" */
+	u32b flags;		/* Flags of the window */
+
+	byte wid;		/* Size of the window */
+	byte hgt;
+};
+
+static overhead_type overhead[ANGBAND_TERM_MAX];
+
+
 /*
  * Hack -- display overhead view in sub-windows.
  *
@@ -1047,6 +1068,10 @@ static void fix_message(void)
  * the "center_player" option not set, this function is only called when the
  * panel changes.
  *
+ * Since "display_map()" must scan the whole level, a window is only drawn
+ * if it can be seen, and if the appearance of the map (see "map_changes")
+ * or the window itself has changed since it was last drawn.
+ *
  * The "display_map()" function handles NULL arguments in a special manner.
  */
 static void fix_overhead(void)
@@ -1058,12 +1083,31 @@ static void fix_overhead(void)
 	{
 		term *old = Term;
 
+		overhead_type *o_ptr = &overhead[j];
+
 		/* No window */
 		if (!angband_term[j]) continue;
 
 		/* No relevant flags */
 		if (!(op_ptr->window_flag[j] & (PW_OVERHEAD))) continue;
 
+		/* Not visible (drawn once it is, since nothing will match) */
+		if (!angband_term[j]->mapped_flag) continue;
+
+		/* Nothing has changed */
+		if (o_ptr->drawn &&
+		    (o_ptr->changes == map_changes) &&
+		    (o_ptr->flags == op_ptr->window_flag[j]) &&
+		    (o_ptr->wid == angband_term[j]->wid) &&
+		    (o_ptr->hgt == angband_term[j]->hgt)) continue;
+
+		/* Remember what is shown */
+		o_ptr->drawn = TRUE;
+		o_ptr->changes = map_changes;
+		o_ptr->flags = op_ptr->window_flag[j];
+		o_ptr->wid = angband_term[j]->wid;
+		o_ptr->hgt = angband_term[j]->hgt;
+
 		/* Activate */
 		Term_activate(angband_term[j]);
 
@@ -2782,10 +2826,23 @@ void redraw_stuff(void)
 
 	if (p_ptr->redraw & (PR_MAP))
 	{
-		p_ptr->redraw &= ~(PR_MAP);
+		p_ptr->redraw &= ~(PR_MAP | PR_PANEL | PR_SPOTS);
+		map_memo_forget();
+		prt_map();
+	}
+
+	if (p_ptr->redraw & (PR_PANEL))
+	{
+		p_ptr->redraw &= ~(PR_PANEL | PR_SPOTS);
 		prt_map();
 	}
 
+	if (p_ptr->redraw & (PR_SPOTS))
+	{
+		p_ptr->redraw &= ~(PR_SPOTS);
+		prt_dirty_spots();
+	}
+
 
 	if (p_ptr->redraw & (PR_BASIC))
 	{
@@ -2943,6 +3000,33 @@ void redraw_stuff(void)
 }
 
 
+/*
+ * Decide whether the overhead view may be drawn now
+ *
+ * While the player is running, resting or repeating a command, it is
+ * drawn at most "OVERHEAD_RATE_MAX" times a second, and "PW_OVERHEAD" is
+ * kept until then.  When the action stops, it is drawn at once.
+ */
+static bool overhead_due(void)
+{
+	static double last_draw = 0.0;
+
+	double now;
+
+	/* Single actions are always shown */
+	if (!p_ptr->running && !p_ptr->resting && !p_ptr->command_rep) return (TRUE);
+
+	/* Too soon */
+	now = profile_now_ms();
+	if (now - last_draw < 1000.0 / OVERHEAD_RATE_MAX) return (FALSE);
+
+	/* Draw it now */
+	last_draw = now;
+
+	return (TRUE);
+}
+
+
 /*
  * Handle "p_ptr->window"
  */
@@ -3009,8 +3093,8 @@ void window_stuff(void)
 		fix_message();
 	}
 
-	/* Display overhead view */
-	if (p_ptr->window & (PW_OVERHEAD))
+	/* Display overhead view (but not too often) */
+	if ((p_ptr->window & (PW_OVERHEAD)) && overhead_due())
 	{
 		p_ptr->window &= ~(PW_OVERHEAD);
 		fix_overhead();
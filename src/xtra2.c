@@ -2431,8 +2431,8 @@ bool modify_panel(int wy, int wx)
 		p_ptr->wy = wy;
 		p_ptr->wx = wx;
 
-		/* Redraw map */
-		p_ptr->redraw |= (PR_MAP);
+		/* Redraw map (nothing on it has changed) */
+		p_ptr->redraw |= (PR_PANEL);
 
 		/* Hack -- Window stuff */
 		p_ptr->window |= (PW_OVERHEAD);
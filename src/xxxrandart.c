@@ -2098,6 +2098,9 @@ errr do_randart(u32b randart_seed, bool full)
 {
 	errr err;
 
+	/* Anything the "complex" RNG does comes from the randart stream */
+	int old_stream = Rand_stream_set(RAND_STREAM_RANDART);
+
 	/* Prepare to use the Angband "simple" RNG. */
 	Rand_value = randart_seed;
 	Rand_quick = TRUE;
@@ -2108,6 +2111,9 @@ errr do_randart(u32b randart_seed, bool full)
 	/* When done, resume use of the Angband "complex" RNG. */
 	Rand_quick = FALSE;
 
+	/* Back to the old stream */
+	(void)Rand_stream_set(old_stream);
+
 	return (err);
 }
 
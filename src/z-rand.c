@@ -33,6 +33,13 @@
  * "random.c" file from Berkeley but with some major optimizations and
  * algorithm changes.  See below for more details.
  *
+ * The "complex" RNG may instead use xoshiro128** (see "Rand_mode"),
+ * which is faster, passes far more statistical tests, and can bound its
+ * results with a multiply and a shift, rarely needing a division.  The
+ * old generator is still used by characters whose savefiles were made
+ * with it, and the "simple" RNG is never changed, so "seeded" things
+ * like flavors and the town look the same whichever is in use.
+ *
  * Some code by Ben Harrison (benh@phial.com).
  *
  * Some code by Randy (randy@stat.tamu.edu).
@@ -48,6 +55,11 @@
  */
 #define LCRNG(X)        ((X) * 1103515245 + 12345)
 
+/*
+ * Rotate a 32-bit value left
+ */
+#define ROTL(X,K)       (((X) << (K)) | ((X) >> (32 - (K))))
+
 
 
 /*
@@ -72,6 +84,71 @@ u16b Rand_place;
  */
 u32b Rand_state[RAND_DEG];
 
+/*
+ * Current algorithm for the "complex" RNG (see "RAND_MODE_*")
+ */
+u16b Rand_mode = RAND_MODE_LEGACY;
+
+/*
+ * Current "stream" of the "complex" RNG (see "RAND_STREAM_*")
+ */
+u16b Rand_stream = RAND_STREAM_MAIN;
+
+/*
+ * Saved "index" and "state" of the other streams
+ */
+u16b Rand_stream_place[RAND_STREAM_MAX];
+u32b Rand_stream_state[RAND_STREAM_MAX][RAND_DEG];
+
+
+
+/*
+ * Extract a 32-bit number from the xoshiro128** state "s"
+ */
+static u32b Rand_fast_next(u32b *s)
+{
+	u32b r = ROTL(s[1] * 5, 7) * 9;
+	u32b t = s[1] << 9;
+
+	s[2] ^= s[0];
+	s[3] ^= s[1];
+	s[1] ^= s[2];
+	s[0] ^= s[3];
+	s[2] ^= t;
+	s[3] = ROTL(s[3], 11);
+
+	return (r);
+}
+
+
+/*
+ * Extract a number from 0 to m-1 from the xoshiro128** state "s"
+ *
+ * The 32-bit number is multiplied by "m" and the top half of the product
+ * is the result.  The few low halves smaller than "2^32 mod m" would make
+ * some results more likely than others, so those are rejected, and the
+ * division needed to find that bound is only done when one might be.
+ */
+static u32b Rand_fast_div(u32b *s, u32b m)
+{
+	unsigned long long p = (unsigned long long)Rand_fast_next(s) * m;
+	u32b low = (u32b)p;
+
+	/* Rare case -- maybe biased */
+	if (low < m)
+	{
+		u32b bound = (0 - m) % m;
+
+		while (low < bound)
+		{
+			p = (unsigned long long)Rand_fast_next(s) * m;
+			low = (u32b)p;
+		}
+	}
+
+	return ((u32b)(p >> 32));
+}
+
 
 
 /*
@@ -100,6 +177,80 @@ void Rand_state_init(u32b seed)
 		/* Advance the index */
 		Rand_place = j;
 	}
+
+	/* Hack -- xoshiro128** must not start from all zeros */
+	if ((Rand_mode == RAND_MODE_FAST) &&
+	    !(Rand_state[0] | Rand_state[1] | Rand_state[2] | Rand_state[3]))
+	{
+		Rand_state[0] = seed | 1;
+	}
+}
+
+
+/*
+ * Seed every stream of the "complex" RNG but the main one from "seed"
+ *
+ * The main stream is left as it is, and becomes the active one.
+ */
+void Rand_streams_init(u32b seed)
+{
+	int s, i;
+
+	/* Put away the main stream */
+	(void)Rand_stream_set(RAND_STREAM_MAIN);
+	Rand_stream_place[RAND_STREAM_MAIN] = Rand_place;
+	for (i = 0; i < RAND_DEG; i++)
+	{
+		Rand_stream_state[RAND_STREAM_MAIN][i] = Rand_state[i];
+	}
+
+	/* Seed the others, each from a different seed */
+	for (s = 1; s < RAND_STREAM_MAX; s++)
+	{
+		Rand_place = 0;
+		Rand_state_init(seed + (u32b)s * 0x9E3779B9UL);
+
+		Rand_stream_place[s] = Rand_place;
+		for (i = 0; i < RAND_DEG; i++) Rand_stream_state[s][i] = Rand_state[i];
+	}
+
+	/* Restore the main stream */
+	Rand_place = Rand_stream_place[RAND_STREAM_MAIN];
+	for (i = 0; i < RAND_DEG; i++)
+	{
+		Rand_state[i] = Rand_stream_state[RAND_STREAM_MAIN][i];
+	}
+}
+
+
+/*
+ * Make "s" the active stream of the "complex" RNG, returning the old one
+ *
+ * Callers switch to their stream on the way in, and back to the returned
+ * stream on the way out.  Only the words the algorithm uses are copied,
+ * so switching is cheap for the "fast" RNG.
+ */
+int Rand_stream_set(int s)
+{
+	int old = Rand_stream;
+	int n = (Rand_mode == RAND_MODE_FAST) ? 4 : RAND_DEG;
+	int i;
+
+	/* Already there */
+	if (s == old) return (old);
+
+	/* Put away the current stream */
+	Rand_stream_place[old] = Rand_place;
+	for (i = 0; i < n; i++) Rand_stream_state[old][i] = Rand_state[i];
+
+	/* Fetch the new one */
+	Rand_place = Rand_stream_place[s];
+	for (i = 0; i < n; i++) Rand_state[i] = Rand_stream_state[s][i];
+
+	/* Remember it */
+	Rand_stream = s;
+
+	return (old);
 }
 
 
@@ -127,6 +278,12 @@ u32b Rand_mod(u32b m)
 		r = ((r >> 4) % m);
 	}
 
+	/* Use the "fast" complex RNG (multiply and shift, slightly biased) */
+	else if (Rand_mode == RAND_MODE_FAST)
+	{
+		r = (u32b)(((unsigned long long)Rand_fast_next(Rand_state) * m) >> 32);
+	}
+
 	/* Use the "complex" RNG */
 	else
 	{
@@ -161,7 +318,7 @@ u32b Rand_mod(u32b m)
  * in the "low" bits of the underlying RNG's.
  *
  * Note that "m" must not be greater than 0x1000000, or division
- * by zero will result.
+ * by zero will result.  The "fast" RNG has no such limit.
  *
  * ToDo: Check for m > 0x1000000.
  */
@@ -172,6 +329,12 @@ u32b Rand_div(u32b m)
 	/* Hack -- simple case */
 	if (m <= 1) return (0);
 
+	/* Use the "fast" complex RNG */
+	if (!Rand_quick && (Rand_mode == RAND_MODE_FAST))
+	{
+		return (Rand_fast_div(Rand_state, m));
+	}
+
 	/* Partition size */
 	n = (0x10000000 / m);
 
@@ -223,6 +386,40 @@ u32b Rand_div(u32b m)
 }
 
 
+/*
+ * Fill "buf" with "n" random numbers from 0 to m-1
+ *
+ * The numbers are exactly those that "n" calls to "Rand_div()" would
+ * give, but the "fast" RNG keeps its state in registers while it makes
+ * them, which is worth having for large numbers of dice.
+ */
+void Rand_fill(u32b *buf, int n, u32b m)
+{
+	int i;
+
+	/* Use the "fast" complex RNG */
+	if (!Rand_quick && (Rand_mode == RAND_MODE_FAST) && (m > 1))
+	{
+		u32b s[4];
+
+		/* Load the state */
+		for (i = 0; i < 4; i++) s[i] = Rand_state[i];
+
+		/* Make the numbers */
+		for (i = 0; i < n; i++) buf[i] = Rand_fast_div(s, m);
+
+		/* Store the state */
+		for (i = 0; i < 4; i++) Rand_state[i] = s[i];
+	}
+
+	/* Use the other RNGs */
+	else
+	{
+		for (i = 0; i < n; i++) buf[i] = Rand_div(m);
+	}
+}
+
+
 
 
 /*
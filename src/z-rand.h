@@ -25,6 +25,34 @@
 #define RAND_DEG 63
 
 
+/*
+ * The algorithms available for the "complex" Random Number Generator.
+ *
+ * The "legacy" one is the additive table generator of old savefiles.
+ * The "fast" one is xoshiro128**, kept in the first four words of the
+ * same table, so the state is saved and restored in the same way.
+ */
+#define RAND_MODE_LEGACY	0
+#define RAND_MODE_FAST		1
+#define RAND_MODE_MAX		2
+
+
+/*
+ * The independent "streams" of the "complex" Random Number Generator.
+ *
+ * Each part of the game draws from a stream of its own, so that changing
+ * how often one part rolls the dice does not change what the others get.
+ * The active stream is the one in "Rand_state" (see "Rand_stream_set()").
+ */
+#define RAND_STREAM_MAIN	0	/* Everything else */
+#define RAND_STREAM_GEN		1	/* Level generation */
+#define RAND_STREAM_COMBAT	2	/* Player attacks and missiles */
+#define RAND_STREAM_AI		3	/* Monster turns */
+#define RAND_STREAM_STORE	4	/* Store maintenance */
+#define RAND_STREAM_RANDART	5	/* Random artifacts */
+#define RAND_STREAM_MAX		6
+
+
 
 
 /**** Available macros ****/
@@ -80,6 +108,10 @@
 extern bool Rand_quick;
 extern u32b Rand_value;
 extern u16b Rand_place;
+extern u16b Rand_mode;
+extern u16b Rand_stream;
+extern u16b Rand_stream_place[RAND_STREAM_MAX];
+extern u32b Rand_stream_state[RAND_STREAM_MAX][RAND_DEG];
 extern u32b Rand_state[RAND_DEG];
 
 
@@ -87,8 +119,11 @@ extern u32b Rand_state[RAND_DEG];
 
 
 extern void Rand_state_init(u32b seed);
+extern void Rand_streams_init(u32b seed);
+extern int Rand_stream_set(int s);
 extern u32b Rand_mod(u32b m);
 extern u32b Rand_div(u32b m);
+extern void Rand_fill(u32b *buf, int n, u32b m);
 extern s16b Rand_normal(int mean, int stand);
 extern u32b Rand_simple(u32b m);
 
@@ -16,6 +16,8 @@
 
 #include "z-virt.h"
 
+#include "replay.h"
+
 
 /*
  * This file provides a generic, efficient, terminal window package,
@@ -407,6 +409,62 @@ static errr term_win_copy(term_win *s, term_win *f, int w, int h)
 }
 
 
+/*
+ * Copy one row of a "term_win" from another
+ */
+static void term_win_copy_row(term_win *s, term_win *f, int w, int y)
+{
+	/* Copy contents */
+	C_COPY(s->a[y], f->a[y], w, byte);
+	C_COPY(s->c[y], f->c[y], w, char);
+
+#ifdef USE_TRANSPARENCY
+	C_COPY(s->ta[y], f->ta[y], w, byte);
+	C_COPY(s->tc[y], f->tc[y], w, char);
+#endif /* USE_TRANSPARENCY */
+}
+
+
+/*
+ * Create the "memorized" screen (see "Term_save()")
+ */
+static void Term_mem_make(void)
+{
+	int w = Term->wid;
+	int h = Term->hgt;
+
+	/* Allocate window */
+	MAKE(Term->mem, term_win);
+
+	/* Initialize window */
+	term_win_init(Term->mem, w, h);
+
+	/* Every (blank) row is held in the "memorized" screen */
+	C_MAKE(Term->mem_row, h, byte);
+	C_BSET(Term->mem_row, 1, h, byte);
+}
+
+
+/*
+ * A row of the "requested" screen is about to change
+ *
+ * The "memorized" screen only holds the rows which have changed since
+ * "Term_save()", so the row is copied there first, unless it already
+ * has been.  Every other row of the saved screen is still on display.
+ */
+static void Term_mem_keep(int y)
+{
+	/* Nothing saved, or row already held */
+	if (!Term->mem || Term->mem_row[y]) return;
+
+	/* Keep the saved row */
+	term_win_copy_row(Term->mem, Term->scr, Term->wid, y);
+
+	/* Remember */
+	Term->mem_row[y] = 1;
+}
+
+
 
 /*** External hooks ***/
 
@@ -428,6 +486,9 @@ errr Term_user(int n)
  */
 errr Term_xtra(int n, int v)
 {
+	/* Hack -- never wait while playing back a recording */
+	if ((n == TERM_XTRA_DELAY) && replay_playing()) return (0);
+
 	/* Verify the hook */
 	if (!Term->xtra_hook) return (-1);
 
@@ -540,6 +601,9 @@ void Term_queue_char(int x, int y, byte a, char c)
 
 #endif /* USE_TRANSPARENCY */
 
+	/* Keep the saved screen */
+	Term_mem_keep(y);
+
 	/* Save the "literal" information */
 	scr_aa[x] = a;
 	scr_cc[x] = c;
@@ -604,6 +668,9 @@ void Term_queue_chars(int x, int y, int n, byte a, cptr s)
 
 #endif /* USE_TRANSPARENCY */
 
+		/* Keep the saved screen */
+		if (x1 < 0) Term_mem_keep(y);
+
 		/* Save the "literal" information */
 		scr_aa[x] = a;
 		scr_cc[x] = *s;
@@ -638,6 +705,89 @@ void Term_queue_chars(int x, int y, int n, byte a, cptr s)
 /*** Refresh routines ***/
 
 
+/*
+ * Number of columns compared at once by "Term_fresh_skip()"
+ */
+#define FRESH_WORD	((int)sizeof(size_t))
+
+
+/*
+ * Compare "FRESH_WORD" bytes of two rows at once
+ *
+ * The bytes are copied into words, which the compiler turns into plain
+ * (possibly unaligned) loads, rather than accessing the rows as words.
+ */
+static bool Term_fresh_same(const void *p, const void *q)
+{
+	size_t u, v;
+
+	(void)memcpy(&u, p, sizeof(u));
+	(void)memcpy(&v, q, sizeof(v));
+
+	return (u == v);
+}
+
+
+/*
+ * Find the first column from "x" to "x2" of row "y" whose contents have
+ * changed, or "x2 + 1" if there is none (see "Term_fresh")
+ *
+ * Unchanged stretches are skipped a word at a time, so the per-grid logic
+ * of the "Term_fresh_row_*()" functions only runs on changed grids and on
+ * the unchanged grids right next to them.
+ */
+static int Term_fresh_skip(int y, int x, int x2)
+{
+	byte *old_aa = Term->old->a[y];
+	char *old_cc = Term->old->c[y];
+
+	byte *scr_aa = Term->scr->a[y];
+	char *scr_cc = Term->scr->c[y];
+
+#ifdef USE_TRANSPARENCY
+
+	byte *old_taa = Term->old->ta[y];
+	char *old_tcc = Term->old->tc[y];
+
+	byte *scr_taa = Term->scr->ta[y];
+	char *scr_tcc = Term->scr->tc[y];
+
+#endif /* USE_TRANSPARENCY */
+
+	/* Skip whole words */
+	while (x + FRESH_WORD <= x2 + 1)
+	{
+		if (!Term_fresh_same(&old_aa[x], &scr_aa[x])) break;
+		if (!Term_fresh_same(&old_cc[x], &scr_cc[x])) break;
+
+#ifdef USE_TRANSPARENCY
+
+		if (!Term_fresh_same(&old_taa[x], &scr_taa[x])) break;
+		if (!Term_fresh_same(&old_tcc[x], &scr_tcc[x])) break;
+
+#endif /* USE_TRANSPARENCY */
+
+		x += FRESH_WORD;
+	}
+
+	/* Find the changed grid */
+	for (; x <= x2; x++)
+	{
+		if (old_aa[x] != scr_aa[x]) break;
+		if (old_cc[x] != scr_cc[x]) break;
+
+#ifdef USE_TRANSPARENCY
+
+		if (old_taa[x] != scr_taa[x]) break;
+		if (old_tcc[x] != scr_tcc[x]) break;
+
+#endif /* USE_TRANSPARENCY */
+	}
+
+	return (x);
+}
+
+
 /*
  * Flush a row of the current window (see "Term_fresh")
  *
@@ -682,8 +832,8 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 	byte na;
 	char nc;
 
-	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++)
+	/* Scan "modified" columns, starting at the first changed one */
+	for (x = Term_fresh_skip(y, x1, x2); x <= x2; x++)
 	{
 		/* See what is currently here */
 		oa = old_aa[x];
@@ -726,6 +876,9 @@ static void Term_fresh_row_pict(int y, int x1, int x2)
 				fn = 0;
 			}
 
+			/* Skip to the next changed grid */
+			x = Term_fresh_skip(y, x + 1, x2) - 1;
+
 			/* Skip */
 			continue;
 		}
@@ -803,8 +956,8 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 	byte na;
 	char nc;
 
-	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++)
+	/* Scan "modified" columns, starting at the first changed one */
+	for (x = Term_fresh_skip(y, x1, x2); x <= x2; x++)
 	{
 		/* See what is currently here */
 		oa = old_aa[x];
@@ -852,6 +1005,9 @@ static void Term_fresh_row_both(int y, int x1, int x2)
 				fn = 0;
 			}
 
+			/* Skip to the next changed grid */
+			x = Term_fresh_skip(y, x + 1, x2) - 1;
+
 			/* Skip */
 			continue;
 		}
@@ -987,8 +1143,8 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 	char nc;
 
 
-	/* Scan "modified" columns */
-	for (x = x1; x <= x2; x++)
+	/* Scan "modified" columns, starting at the first changed one */
+	for (x = Term_fresh_skip(y, x1, x2); x <= x2; x++)
 	{
 		/* See what is currently here */
 		oa = old_aa[x];
@@ -1020,6 +1176,9 @@ static void Term_fresh_row_text(int y, int x1, int x2)
 				fn = 0;
 			}
 
+			/* Skip to the next changed grid */
+			x = Term_fresh_skip(y, x + 1, x2) - 1;
+
 			/* Skip */
 			continue;
 		}
@@ -1208,6 +1367,9 @@ errr Term_fresh(void)
 	/* Do nothing unless "mapped" */
 	if (!Term->mapped_flag) return (1);
 
+	/* Hack -- show nothing while playing back a recording */
+	if (replay_playing()) return (0);
+
 
 	/* Trivial Refresh */
 	if ((y1 > y2) &&
@@ -1745,6 +1907,9 @@ errr Term_erase(int x, int y, int n)
 		/* Hack -- Ignore "non-changes" */
 		if ((oa == na) && (oc == nc)) continue;
 
+		/* Keep the saved screen */
+		if (x1 < 0) Term_mem_keep(y);
+
 		/* Save the "literal" information */
 		scr_aa[x] = na;
 		scr_cc[x] = nc;
@@ -1810,6 +1975,9 @@ errr Term_clear(void)
 		char *scr_tcc = Term->scr->tc[y];
 #endif /* USE_TRANSPARENCY */
 
+		/* Keep the saved screen */
+		Term_mem_keep(y);
+
 		/* Wipe each column */
 		for (x = 0; x < w; x++)
 		{
@@ -1990,6 +2158,7 @@ errr Term_flush(void)
 
 	/* Forget all keypresses */
 	Term->key_head = Term->key_tail = 0;
+	Term->key_pushed = 0;
 
 	/* Success */
 	return (0);
@@ -2038,6 +2207,9 @@ errr Term_key_push(int k)
 	/* Back up, Store the char */
 	Term->key_queue[--Term->key_tail] = k;
 
+	/* Remember it came from the game (see "Term_inkey()") */
+	Term->key_pushed++;
+
 	/* Success (unless overflow) */
 	if (Term->key_head != Term->key_tail) return (0);
 
@@ -2076,6 +2248,28 @@ errr Term_inkey(char *ch, bool wait, bool take)
 		Term_xtra(TERM_XTRA_BORED, 0);
 	}
 
+	/* Play back a recording, once any keys pushed back are used up */
+	if (replay_playing() && !Term->key_pushed)
+	{
+		int result;
+
+		/* Get the next key (a wait never finds nothing) */
+		do
+		{
+			result = replay_next(ch, take);
+		}
+		while (wait && (result == REPLAY_NONE));
+
+		/* The recording is over */
+		if (result == REPLAY_END)
+		{
+			replay_close();
+			quit(NULL);
+		}
+
+		return ((result == REPLAY_KEY) ? 0 : 1);
+	}
+
 	/* Wait */
 	if (wait)
 	{
@@ -2099,11 +2293,29 @@ errr Term_inkey(char *ch, bool wait, bool take)
 	}
 
 	/* No keys are ready */
-	if (Term->key_head == Term->key_tail) return (1);
+	if (Term->key_head == Term->key_tail)
+	{
+		/* Record the failure */
+		replay_record_key(0, take);
+
+		return (1);
+	}
 
 	/* Extract the next keypress */
 	(*ch) = Term->key_queue[Term->key_tail];
 
+	/* Keys pushed back by the game come back by themselves */
+	if (Term->key_pushed)
+	{
+		if (take) Term->key_pushed--;
+	}
+
+	/* Record the keypress */
+	else
+	{
+		replay_record_key(*ch, take);
+	}
+
 	/* If requested, advance the queue, wrap around if necessary */
 	if (take && (++Term->key_tail == Term->key_size)) Term->key_tail = 0;
 
@@ -2123,21 +2335,19 @@ errr Term_inkey(char *ch, bool wait, bool take)
  */
 errr Term_save(void)
 {
-	int w = Term->wid;
 	int h = Term->hgt;
 
 	/* Create */
-	if (!Term->mem)
-	{
-		/* Allocate window */
-		MAKE(Term->mem, term_win);
+	if (!Term->mem) Term_mem_make();
 
-		/* Initialize window */
-		term_win_init(Term->mem, w, h);
-	}
+	/* Nothing has changed yet (rows are copied as they change) */
+	C_WIPE(Term->mem_row, h, byte);
 
-	/* Grab */
-	term_win_copy(Term->mem, Term->scr, w, h);
+	/* Grab the cursor */
+	Term->mem->cx = Term->scr->cx;
+	Term->mem->cy = Term->scr->cy;
+	Term->mem->cu = Term->scr->cu;
+	Term->mem->cv = Term->scr->cv;
 
 	/* Success */
 	return (0);
@@ -2157,29 +2367,34 @@ errr Term_load(void)
 	int h = Term->hgt;
 
 	/* Create */
-	if (!Term->mem)
+	if (!Term->mem) Term_mem_make();
+
+	/* Load the rows which have changed */
+	for (y = 0; y < h; y++)
 	{
-		/* Allocate window */
-		MAKE(Term->mem, term_win);
+		/* Unchanged */
+		if (!Term->mem_row[y]) continue;
 
-		/* Initialize window */
-		term_win_init(Term->mem, w, h);
-	}
+		/* Load */
+		term_win_copy_row(Term->scr, Term->mem, w, y);
 
-	/* Load */
-	term_win_copy(Term->scr, Term->mem, w, h);
+		/* The saved screen is on display again */
+		Term->mem_row[y] = 0;
 
-	/* Assume change */
-	for (y = 0; y < h; y++)
-	{
 		/* Assume change */
 		Term->x1[y] = 0;
 		Term->x2[y] = w - 1;
+
+		/* Check for new min/max row info */
+		if (y < Term->y1) Term->y1 = y;
+		if (y > Term->y2) Term->y2 = y;
 	}
 
-	/* Assume change */
-	Term->y1 = 0;
-	Term->y2 = h - 1;
+	/* Load the cursor */
+	Term->scr->cx = Term->mem->cx;
+	Term->scr->cy = Term->mem->cy;
+	Term->scr->cu = Term->mem->cu;
+	Term->scr->cv = Term->mem->cv;
 
 	/* Success */
 	return (0);
@@ -2209,6 +2424,9 @@ errr Term_exchange(void)
 		term_win_init(Term->tmp, w, h);
 	}
 
+	/* Keep the saved screen */
+	for (y = 0; y < h; y++) Term_mem_keep(y);
+
 	/* Swap */
 	exchanger = Term->scr;
 	Term->scr = Term->tmp;
@@ -2266,6 +2484,9 @@ errr Term_resize(int w, int h)
 	wid = MIN(Term->wid, w);
 	hgt = MIN(Term->hgt, h);
 
+	/* Keep the whole saved screen */
+	for (i = 0; i < Term->hgt; i++) Term_mem_keep(i);
+
 	/* Save scanners */
 	hold_x1 = Term->x1;
 	hold_x2 = Term->x2;
@@ -2315,6 +2536,11 @@ errr Term_resize(int w, int h)
 
 		/* Save the contents */
 		term_win_copy(Term->mem, hold_mem, wid, hgt);
+
+		/* Every row is held in the "memorized" screen */
+		C_KILL(Term->mem_row, Term->hgt, byte);
+		C_MAKE(Term->mem_row, h, byte);
+		C_BSET(Term->mem_row, 1, h, byte);
 	}
 
 	/* If needed */
@@ -2493,6 +2719,9 @@ errr term_nuke(term *t)
 
 		/* Kill "memorized" */
 		KILL(t->mem, term_win);
+
+		/* Kill the row flags */
+		C_KILL(t->mem_row, h, byte);
 	}
 
 	/* If needed */
@@ -122,6 +122,8 @@ struct term_win
  *
  *	- Keypress Queue -- pending keys
  *
+ *	- Keypress Queue -- keys pushed back by the game
+ *
  *
  *	- Window Width (max 255)
  *	- Window Height (max 255)
@@ -191,6 +193,8 @@ struct term
 	u16b key_xtra;
 	u16b key_size;
 
+	u16b key_pushed;
+
 	byte wid;
 	byte hgt;
 
@@ -206,6 +210,8 @@ struct term
 	term_win *tmp;
 	term_win *mem;
 
+	byte *mem_row;
+
 	void (*init_hook)(term *t);
 	void (*nuke_hook)(term *t);
 